@@ -110,6 +110,22 @@ project "rlTPCamera"
 	}
 	files {"cameras/rlTPCamera/*.cpp","cameras/rlTPCamera/*.h"}
 	include_raylib()
+
+project "rlAssets"
+	kind "StaticLib"
+	
+	location "_build"
+	targetdir "_bin/%{cfg.buildcfg}"
+	language "C++"
+	
+	includedirs { "raylib/src"}
+	vpaths 
+	{
+		["Header Files"] = { "rlAssets/*.h"},
+		["Source Files"] = {"rlAssets/*.cpp"},
+	}
+	files {"rlAssets/*.cpp","rlAssets/*.h"}
+	include_raylib()
 	
 group "Examples"
 project "rlFPCamera_sample"
@@ -149,3 +165,67 @@ project "rlTPCamera_sample"
 	includedirs {"./", "cameras/rlTPCamera" }
 	
 	link_raylib()
+
+group "Tools"
+project "rlas_pack"
+	kind "ConsoleApp"
+	location "_build"
+	targetdir "_bin/%{cfg.buildcfg}"
+	language "C++"
+
+	vpaths 
+	{
+		["Header Files"] = { "rlAssets/*.h"},
+		["Source Files"] = {"rlAssets/tools/*.cpp", "rlAssets/rlAssets_platforms.cpp" },
+	}
+	files {"rlAssets/tools/*.cpp", "rlAssets/rlAssets_platforms.cpp", "rlAssets/rlAssets_pack.h", "rlAssets/rlAssets_platforms.h"}
+
+group "Benchmarks"
+project "rlAssets_benchmark"
+	kind "ConsoleApp"
+	location "_build"
+	targetdir "_bin/%{cfg.buildcfg}"
+	language "C++"
+
+	vpaths 
+	{
+		["Source Files"] = {"rlAssets/benchmark/vfs_benchmark.cpp" },
+	}
+	files {"rlAssets/benchmark/vfs_benchmark.cpp"}
+
+	links {"rlAssets"}
+	
+	includedirs {"./", "rlAssets" }
+	
+	link_raylib()
+
+project "rlAssets_lookup_benchmark"
+	kind "ConsoleApp"
+	location "_build"
+	targetdir "_bin/%{cfg.buildcfg}"
+	language "C++"
+
+	vpaths 
+	{
+		["Header Files"] = { "rlAssets/rlAssets_index.h"},
+		["Source Files"] = {"rlAssets/benchmark/lookup_benchmark.cpp" },
+	}
+	files {"rlAssets/benchmark/lookup_benchmark.cpp", "rlAssets/rlAssets_index.h"}
+
+group "Tests"
+project "rlAssets_tests"
+	kind "ConsoleApp"
+	location "_build"
+	targetdir "_bin/%{cfg.buildcfg}"
+	language "C++"
+
+	vpaths 
+	{
+		["Header Files"] = { "rlAssets/*.h"},
+		["Source Files"] = {"rlAssets/tests/rlAssets_tests.cpp", "rlAssets/rlAssets_platforms.cpp" },
+	}
+	files {"rlAssets/tests/rlAssets_tests.cpp", "rlAssets/rlAssets_platforms.cpp", "rlAssets/*.h"}
+
+	includedirs {"./", "rlAssets" }
+	
+	link_raylib()
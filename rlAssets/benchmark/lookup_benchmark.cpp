@@ -0,0 +1,140 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAsset Benchmark * Virtual path lookup throughput
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+// Compares the rlAssets path index against the upper cased std::map lookup it replaced
+// Usage: lookup_benchmark [asset count] [lookup count]
+
+#include "../rlAssets_index.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+struct BenchMeta
+{
+    std::string RelativeName;
+    std::string PathOnDisk;
+};
+
+std::string ToUpper(const char* c)
+{
+    if (c == nullptr)
+        return std::string();
+
+    std::string upperPath = c;
+    for (auto& c : upperPath)
+        c = toupper(c);
+
+    return upperPath;
+}
+
+std::vector<std::string> MakeNames(int count)
+{
+    static const char* folders[] = { "textures/", "textures/ui/", "sounds/", "music/", "shaders/", "levels/a/", "levels/b/", "fonts/" };
+    static const char* extensions[] = { ".png", ".ogg", ".fs", ".vs", ".json", ".ttf" };
+
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (int i = 0; i < count; ++i)
+        names.push_back(std::string(folders[i % 8]) + "asset_" + std::to_string(i) + extensions[i % 6]);
+
+    return names;
+}
+
+double SecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    int assetCount = argc > 1 ? atoi(argv[1]) : 50000;
+    int lookupCount = argc > 2 ? atoi(argv[2]) : 2000000;
+
+    std::vector<std::string> names = MakeNames(assetCount);
+
+    // queries use a different case than the index, like game code usually does
+    std::vector<std::string> queries;
+    queries.reserve(assetCount);
+    for (auto& name : names)
+    {
+        std::string query = name;
+        for (size_t i = 0; i < query.size(); i += 2)
+            query[i] = toupper(query[i]);
+        queries.push_back(query);
+    }
+
+    std::map<std::string, BenchMeta> mapIndex;
+    rlas_PathIndex<BenchMeta> hashIndex;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto& name : names)
+        mapIndex[ToUpper(name.c_str())] = BenchMeta{ name, name };
+    double mapBuild = SecondsSince(start);
+
+    start = std::chrono::high_resolution_clock::now();
+    for (auto& name : names)
+        hashIndex.Set(name, BenchMeta{ name, name });
+    double hashBuild = SecondsSince(start);
+
+    size_t mapFound = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < lookupCount; ++i)
+    {
+        if (mapIndex.find(ToUpper(queries[i % assetCount].c_str())) != mapIndex.end())
+            ++mapFound;
+    }
+    double mapLookup = SecondsSince(start);
+
+    size_t hashFound = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < lookupCount; ++i)
+    {
+        if (hashIndex.Find(queries[i % assetCount].c_str()) != nullptr)
+            ++hashFound;
+    }
+    double hashLookup = SecondsSince(start);
+
+    if (mapFound != hashFound)
+    {
+        printf("lookup mismatch: map found %zu, index found %zu\n", mapFound, hashFound);
+        return 1;
+    }
+
+    printf("assets: %d lookups: %d\n", assetCount, lookupCount);
+    printf("%-10s build %8.3f ms  lookup %8.3f ms  %10.2f Mlookups/s\n", "std::map", mapBuild * 1000, mapLookup * 1000, lookupCount / mapLookup / 1e6);
+    printf("%-10s build %8.3f ms  lookup %8.3f ms  %10.2f Mlookups/s\n", "PathIndex", hashBuild * 1000, hashLookup * 1000, lookupCount / hashLookup / 1e6);
+
+    return 0;
+}
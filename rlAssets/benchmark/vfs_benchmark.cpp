@@ -0,0 +1,592 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAsset Benchmark * Virtual file system hot paths
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+// Builds a synthetic resource tree and a zip of the same files, then times the rlAssets hot paths against them
+// Usage: vfs_benchmark [-f file count] [-d depth] [-w folders per folder] [-s average file size in bytes]
+//                      [-c compressible fraction 0-1] [-n lookup count] [-r repeats] [-p work directory] [-o results.json]
+// The tree is written to the work directory (rlas_bench by default) and left there, results are printed as a table and optionally written as JSON
+
+#include "raylib.h"
+#include "../rlAssets.h"
+#include "../rlAssets_platforms.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+constexpr char PathDelim = '\\';
+#else
+constexpr char PathDelim = '/';
+#endif // OSs
+
+// miniz is compiled into rlAssets, only the two functions the zip writer needs are declared here
+extern "C"
+{
+    unsigned long mz_crc32(unsigned long crc, const unsigned char* ptr, size_t buf_len);
+    size_t tdefl_compress_mem_to_mem(void* pOut_buf, size_t out_buf_len, const void* pSrc_buf, size_t src_buf_len, int flags);
+}
+
+static const int DeflateProbes = 128;   // miniz's default level, raw deflate without a zlib header
+
+struct BenchConfig
+{
+    int FileCount = 2000;
+    int Depth = 3;
+    int Fanout = 4;
+    int FileSize = 16 * 1024;
+    float Compressible = 0.5f;
+    int LookupCount = 1000000;
+    int Repeats = 5;
+    std::string WorkPath = "rlas_bench";
+    std::string JsonPath;
+};
+
+struct BenchResult
+{
+    std::string Name;
+    uint64_t Ops = 0;
+    uint64_t Bytes = 0;
+    double Seconds = 0;         // fastest repeat
+    double MedianSeconds = 0;
+};
+
+// a minimal zip writer, entries are deflated unless that does not make them smaller
+class ZipWriter
+{
+public:
+    bool Begin(const std::string& path)
+    {
+        File = fopen(path.c_str(), "wb");
+        return File != nullptr;
+    }
+
+    bool Add(const std::string& name, const std::vector<unsigned char>& data)
+    {
+        Entry entry;
+        entry.Name = name;
+        entry.Crc = (uint32_t)mz_crc32(0, data.data(), data.size());
+        entry.Size = (uint32_t)data.size();
+        entry.Offset = (uint32_t)ftell(File);
+
+        Compressed.resize(data.size());
+        size_t compressed = data.empty() ? 0 : tdefl_compress_mem_to_mem(Compressed.data(), Compressed.size(), data.data(), data.size(), DeflateProbes);
+        entry.Method = compressed > 0 && compressed < data.size() ? 8 : 0;
+        entry.CompressedSize = entry.Method == 8 ? (uint32_t)compressed : entry.Size;
+
+        Put32(0x04034b50);
+        PutHeader(entry);
+        Put16(0);   // extra length
+        fwrite(name.data(), 1, name.size(), File);
+        fwrite(entry.Method == 8 ? Compressed.data() : data.data(), 1, entry.CompressedSize, File);
+
+        Entries.push_back(entry);
+        return !ferror(File);
+    }
+
+    bool Finish()
+    {
+        uint32_t directoryOffset = (uint32_t)ftell(File);
+        for (auto& entry : Entries)
+        {
+            Put32(0x02014b50);
+            Put16(20);  // made by
+            PutHeader(entry);
+            Put16(0);   // extra length
+            Put16(0);   // comment length
+            Put16(0);   // disk
+            Put16(0);   // internal attributes
+            Put32(0);   // external attributes
+            Put32(entry.Offset);
+            fwrite(entry.Name.data(), 1, entry.Name.size(), File);
+        }
+        uint32_t directorySize = (uint32_t)ftell(File) - directoryOffset;
+
+        Put32(0x06054b50);
+        Put16(0);
+        Put16(0);
+        Put16((uint16_t)Entries.size());
+        Put16((uint16_t)Entries.size());
+        Put32(directorySize);
+        Put32(directoryOffset);
+        Put16(0);   // comment length
+
+        bool written = !ferror(File);
+        return fclose(File) == 0 && written;
+    }
+
+private:
+    struct Entry
+    {
+        std::string Name;
+        uint32_t Crc = 0;
+        uint32_t Size = 0;
+        uint32_t CompressedSize = 0;
+        uint32_t Offset = 0;
+        uint16_t Method = 0;
+    };
+
+    // the part of the header that is the same in the local and central headers, up to the name length
+    void PutHeader(const Entry& entry)
+    {
+        Put16(20);      // version needed
+        Put16(0);       // flags
+        Put16(entry.Method);
+        Put16(0);       // time
+        Put16(0x21);    // date, 1980-01-01
+        Put32(entry.Crc);
+        Put32(entry.CompressedSize);
+        Put32(entry.Size);
+        Put16((uint16_t)entry.Name.size());
+    }
+
+    void Put16(uint16_t value)
+    {
+        unsigned char bytes[2] = { (unsigned char)value, (unsigned char)(value >> 8) };
+        fwrite(bytes, 1, 2, File);
+    }
+
+    void Put32(uint32_t value)
+    {
+        Put16((uint16_t)value);
+        Put16((uint16_t)(value >> 16));
+    }
+
+    FILE* File = nullptr;
+    std::vector<Entry> Entries;
+    std::vector<unsigned char> Compressed;
+};
+
+// the same seed always builds the same tree, so results from different runs can be compared
+uint64_t NextRandom(uint64_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+void MakeFileData(int index, const BenchConfig& config, std::vector<unsigned char>& data)
+{
+    static const char text[] = "the quick brown fox jumps over the lazy dog while rlAssets reads it ";
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL * (uint64_t)(index + 1);
+    size_t size = (size_t)config.FileSize / 2 + (size_t)(NextRandom(state) % (uint64_t)(config.FileSize + 1));
+    size_t compressible = (size_t)(size * std::min(std::max(config.Compressible, 0.0f), 1.0f));
+
+    data.resize(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = i < compressible ? (unsigned char)text[i % (sizeof(text) - 1)] : (unsigned char)NextRandom(state);
+}
+
+// builds <work>/loose/ with the files and <work>/packed/archive.zip with the same files
+bool BuildTree(const BenchConfig& config, std::vector<std::string>& folders, std::vector<std::string>& names)
+{
+    folders.assign(1, std::string());
+    size_t levelStart = 0;
+    for (int level = 0; level < config.Depth; ++level)
+    {
+        size_t levelEnd = folders.size();
+        for (size_t parent = levelStart; parent < levelEnd; ++parent)
+        {
+            for (int child = 0; child < config.Fanout; ++child)
+                folders.push_back(folders[parent] + "d" + std::to_string(child) + "/");
+        }
+        levelStart = levelEnd;
+    }
+
+    std::string loose = config.WorkPath + PathDelim + "loose" + PathDelim;
+    std::string packed = config.WorkPath + PathDelim + "packed" + PathDelim;
+    if (!rlas_CreateDirectory(config.WorkPath.c_str()) || !rlas_CreateDirectory(loose.c_str()) || !rlas_CreateDirectory(packed.c_str()))
+        return false;
+
+    for (auto& folder : folders)
+    {
+        std::string path = folder;
+        std::replace(path.begin(), path.end(), '/', PathDelim);
+        if (!folder.empty() && !rlas_CreateDirectory((loose + path).c_str()))
+            return false;
+    }
+
+    ZipWriter zip;
+    if (!zip.Begin(packed + "archive.zip"))
+        return false;
+
+    names.clear();
+    std::vector<unsigned char> data;
+    for (int i = 0; i < config.FileCount; ++i)
+    {
+        std::string name = folders[i % folders.size()] + "file_" + std::to_string(i) + ".bin";
+        MakeFileData(i, config, data);
+
+        std::string path = loose + name;
+        std::replace(path.begin() + loose.size(), path.end(), '/', PathDelim);
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+        bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+        if (fclose(file) != 0 || !written || !zip.Add(name, data))
+            return false;
+
+        names.push_back(name);
+    }
+
+    return zip.Finish();
+}
+
+// times a run several times, setup is called before each run and is not timed
+template<class Setup, class Run>
+BenchResult Measure(const char* name, int repeats, Setup setup, Run run)
+{
+    BenchResult result;
+    result.Name = name;
+
+    std::vector<double> times;
+    for (int i = 0; i < repeats; ++i)
+    {
+        setup();
+        result.Ops = 0;
+        result.Bytes = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        run(result);
+        times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    result.Seconds = times.front();
+    result.MedianSeconds = times[times.size() / 2];
+    return result;
+}
+
+void PrintResults(const std::vector<BenchResult>& results)
+{
+    printf("%-18s %10s %12s %12s %14s %10s\n", "benchmark", "ops", "best ms", "median ms", "ns/op", "MB/s");
+    for (auto& result : results)
+    {
+        double perOp = result.Ops > 0 ? result.Seconds * 1e9 / result.Ops : 0;
+        double rate = result.Seconds > 0 ? result.Bytes / result.Seconds / (1024 * 1024) : 0;
+        printf("%-18s %10llu %12.3f %12.3f %14.1f %10.1f\n", result.Name.c_str(), (unsigned long long)result.Ops, result.Seconds * 1000, result.MedianSeconds * 1000, perOp, rate);
+    }
+}
+
+bool WriteJson(const std::string& path, const BenchConfig& config, const std::vector<BenchResult>& results)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "{\n  \"config\": { \"files\": %d, \"depth\": %d, \"fanout\": %d, \"fileSize\": %d, \"compressible\": %.3f, \"lookups\": %d, \"repeats\": %d },\n  \"results\": [",
+        config.FileCount, config.Depth, config.Fanout, config.FileSize, config.Compressible, config.LookupCount, config.Repeats);
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult& result = results[i];
+        double perOp = result.Ops > 0 ? result.Seconds * 1e9 / result.Ops : 0;
+        double rate = result.Seconds > 0 ? result.Bytes / result.Seconds : 0;
+        fprintf(file, "%s\n    { \"name\": \"%s\", \"ops\": %llu, \"bytes\": %llu, \"seconds\": %.9f, \"medianSeconds\": %.9f, \"nsPerOp\": %.3f, \"bytesPerSecond\": %.1f }",
+            i == 0 ? "" : ",", result.Name.c_str(), (unsigned long long)result.Ops, (unsigned long long)result.Bytes, result.Seconds, result.MedianSeconds, perOp, rate);
+    }
+
+    fputs("\n  ]\n}\n", file);
+    return fclose(file) == 0;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchConfig config;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-f") == 0)
+            config.FileCount = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-d") == 0)
+            config.Depth = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-w") == 0)
+            config.Fanout = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-s") == 0)
+            config.FileSize = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-c") == 0)
+            config.Compressible = (float)atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-n") == 0)
+            config.LookupCount = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-r") == 0)
+            config.Repeats = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-p") == 0)
+            config.WorkPath = argv[i + 1];
+        else if (strcmp(argv[i], "-o") == 0)
+            config.JsonPath = argv[i + 1];
+    }
+
+    if (config.FileCount < 1 || config.FileCount > 65535 || config.Depth < 0 || config.Fanout < 1 || config.FileSize < 0 || config.LookupCount < 1 || config.Repeats < 1)
+    {
+        printf("usage: vfs_benchmark [-f files 1-65535] [-d depth] [-w folders per folder] [-s average file size] [-c compressible fraction 0-1] [-n lookups] [-r repeats] [-p work directory] [-o results.json]\n");
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    std::vector<std::string> folders;
+    std::vector<std::string> names;
+    if (!BuildTree(config, folders, names))
+    {
+        printf("could not build the test tree in %s\n", config.WorkPath.c_str());
+        return 1;
+    }
+
+    std::string work = config.WorkPath + PathDelim;
+    std::string empty = work + "empty" + PathDelim;
+    std::string loose = work + "loose" + PathDelim;
+    std::string packed = work + "packed" + PathDelim;
+    std::string temp = work + "temp" + PathDelim;
+    rlas_CreateDirectory(empty.c_str());
+    rlas_CreateDirectory(temp.c_str());
+
+    auto reset = [&empty]()
+    {
+        rlas_Cleanup();
+        rlas_SetAssetRootPath(empty.c_str(), false);
+    };
+
+    auto mountAll = [&]()
+    {
+        reset();
+        rlas_AddAssetResourcePath(loose.c_str());
+        rlas_AddAssetResourcePath(packed.c_str());
+    };
+
+    // queries use a different case than the files and one in ten misses
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        std::string query = (i % 2 == 0 ? "" : "archive/") + names[i];
+        for (size_t c = 0; c < query.size(); c += 2)
+            query[c] = (char)toupper(query[c]);
+        if (i % 10 == 9)
+            query += ".missing";
+        queries.push_back(query);
+    }
+
+    std::vector<BenchResult> results;
+
+    results.push_back(Measure("index_directory", config.Repeats, reset, [&](BenchResult& result)
+    {
+        rlas_AddAssetResourcePath(loose.c_str());
+        result.Ops = names.size();
+    }));
+
+    // only the top directory is listed, the rest is read by the recursive listing
+    results.push_back(Measure("index_lazy", config.Repeats, reset, [&](BenchResult& result)
+    {
+        rlas_SetLazyIndexing(true);
+        rlas_AddAssetResourcePath(loose.c_str());
+        rlas_SetLazyIndexing(false);
+        result.Ops = names.size();
+    }));
+
+    results.push_back(Measure("index_lazy_full", config.Repeats, reset, [&](BenchResult& result)
+    {
+        rlas_SetLazyIndexing(true);
+        rlas_AddAssetResourcePath(loose.c_str());
+        rlas_SetLazyIndexing(false);
+        result.Ops = (uint64_t)rlas_ListAssetsInPath("", true, nullptr, 0);
+    }));
+
+    // each directory is read by the first lookup that reaches it
+    results.push_back(Measure("index_lazy_lookups", config.Repeats, reset, [&](BenchResult& result)
+    {
+        rlas_SetLazyIndexing(true);
+        rlas_AddAssetResourcePath(loose.c_str());
+        rlas_SetLazyIndexing(false);
+        for (auto& name : names)
+            result.Ops += rlas_GetFileSize(name.c_str()) != 0 ? 1 : 0;
+    }));
+
+    std::string zipPath = packed + "archive.zip";
+    results.push_back(Measure("index_archive", config.Repeats, reset, [&](BenchResult& result)
+    {
+        rlas_AddAssetResourceArchive(zipPath.c_str(), false);
+        result.Ops = names.size();
+    }));
+
+    // mounting only adds to the mount list, the archive is read by the first lookup under the prefix
+    results.push_back(Measure("mount_archive", config.Repeats, reset, [&](BenchResult& result)
+    {
+        rlas_Mount(zipPath.c_str(), "mod", 0);
+        result.Ops = 1;
+    }));
+
+    results.push_back(Measure("mount_first_lookup", config.Repeats, reset, [&](BenchResult& result)
+    {
+        rlas_Mount(zipPath.c_str(), "mod", 0);
+        rlas_FileIsArchive(("mod/" + names[0]).c_str());
+        result.Ops = names.size();
+    }));
+
+    // unmounting shares the indexed directory with the new layers, only the mount and its own table are freed
+    rlas_MountId layer = 0;
+    results.push_back(Measure("unmount_layer", config.Repeats, [&]() { reset(); rlas_AddAssetResourcePath(loose.c_str()); layer = rlas_Mount(zipPath.c_str(), "mod", 0); rlas_FileIsArchive(("mod/" + names[0]).c_str()); }, [&](BenchResult& result)
+    {
+        rlas_Unmount(layer);
+        result.Ops = names.size();
+    }));
+
+    mountAll();
+
+    results.push_back(Measure("lookup", config.Repeats, []() {}, [&](BenchResult& result)
+    {
+        size_t found = 0;
+        for (int i = 0; i < config.LookupCount; ++i)
+            found += rlas_FileIsArchive(queries[i % queries.size()].c_str()) ? 1 : 0;
+
+        result.Ops = (uint64_t)config.LookupCount;
+        if (found == 0)
+            printf("lookup found no archive assets\n");
+    }));
+
+    std::vector<rlas_AssetHandle> handles;
+    for (auto& query : queries)
+        handles.push_back(rlas_ResolveHandle(query.c_str()));
+
+    results.push_back(Measure("lookup_handle", config.Repeats, []() {}, [&](BenchResult& result)
+    {
+        size_t found = 0;
+        for (int i = 0; i < config.LookupCount; ++i)
+            found += rlas_FileIsArchiveByHandle(handles[i % handles.size()]) ? 1 : 0;
+
+        result.Ops = (uint64_t)config.LookupCount;
+        if (found == 0)
+            printf("lookup_handle found no archive assets\n");
+    }));
+
+    // every lookup has to get past mounts that override the asset map, the path is hashed once for all of them
+    std::vector<rlas_MountId> overrides = { rlas_Mount(empty.c_str(), "", 2), rlas_Mount(loose.c_str(), "", 1), rlas_Mount(zipPath.c_str(), "archive", 1) };
+    results.push_back(Measure("lookup_mounted", config.Repeats, []() {}, [&](BenchResult& result)
+    {
+        size_t found = 0;
+        for (int i = 0; i < config.LookupCount; ++i)
+            found += rlas_FileIsArchive(queries[i % queries.size()].c_str()) ? 1 : 0;
+
+        result.Ops = (uint64_t)config.LookupCount;
+        if (found == 0)
+            printf("lookup_mounted found no archive assets\n");
+    }));
+
+    for (rlas_MountId mount : overrides)
+        rlas_Unmount(mount);
+
+    results.push_back(Measure("list_folders", config.Repeats, []() {}, [&](BenchResult& result)
+    {
+        for (auto& folder : folders)
+            rlas_GetAssetsInPath(folder.c_str(), false, nullptr);
+        result.Ops = folders.size();
+    }));
+
+    results.push_back(Measure("list_recursive", config.Repeats, []() {}, [&](BenchResult& result)
+    {
+        rlas_GetAssetsInPath("", true, nullptr);
+        result.Ops = 1;
+    }));
+
+    results.push_back(Measure("load_directory", config.Repeats, []() {}, [&](BenchResult& result)
+    {
+        for (auto& name : names)
+        {
+            unsigned int size = 0;
+            unsigned char* data = LoadFileData(name.c_str(), &size);
+            result.Bytes += size;
+            UnloadFileData(data);
+        }
+        result.Ops = names.size();
+    }));
+
+    results.push_back(Measure("load_archive", config.Repeats, []() {}, [&](BenchResult& result)
+    {
+        for (auto& name : names)
+        {
+            unsigned int size = 0;
+            unsigned char* data = LoadFileData(("archive/" + name).c_str(), &size);
+            result.Bytes += size;
+            UnloadFileData(data);
+        }
+        result.Ops = names.size();
+    }));
+
+    std::vector<std::string> archiveNames;
+    for (auto& name : names)
+        archiveNames.push_back("archive/" + name);
+
+    std::vector<const char*> batchPaths;
+    for (auto& name : archiveNames)
+        batchPaths.push_back(name.c_str());
+
+    results.push_back(Measure("load_archive_batch", config.Repeats, []() {}, [&](BenchResult& result)
+    {
+        std::vector<unsigned char*> data(batchPaths.size());
+        std::vector<unsigned int> sizes(batchPaths.size());
+        rlas_LoadBatch(batchPaths.data(), (int)batchPaths.size(), data.data(), sizes.data());
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            result.Bytes += sizes[i];
+            UnloadFileData(data[i]);
+        }
+        result.Ops = names.size();
+    }));
+
+    // every extraction writes a file, remounting before each run makes sure nothing is reused
+    results.push_back(Measure("extract_archive", config.Repeats, [&]() { mountAll(); rlas_SetTempPath(temp.c_str()); }, [&](BenchResult& result)
+    {
+        for (auto& name : names)
+        {
+            const char* path = rlas_GetAssetPath(("archive/" + name).c_str());
+            if (path != nullptr)
+                result.Bytes += rlas_GetFileSize(("archive/" + name).c_str());
+        }
+        result.Ops = names.size();
+    }));
+
+    rlas_Cleanup();
+
+    printf("files: %d folders: %d average size: %d compressible: %.2f repeats: %d\n", config.FileCount, (int)folders.size(), config.FileSize, config.Compressible, config.Repeats);
+    PrintResults(results);
+
+    if (!config.JsonPath.empty() && !WriteJson(config.JsonPath, config, results))
+    {
+        printf("could not write %s\n", config.JsonPath.c_str());
+        return 1;
+    }
+
+    return 0;
+}
@@ -28,17 +28,24 @@
 *
 **********************************************************************************************/
 
-#include "RLAssets.h"
+#include "rlAssets.h"
 
-#include <map>
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <ostream>
+#include <map>
+#include <set>
+#include <deque>
 #include <memory>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <chrono>
 
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 
 #if defined(_WIN32)
 constexpr char PathDelim = '\\';
@@ -50,390 +57,4318 @@ constexpr char PathDelim = '/';
 #endif // OSs
 
 #include "zip_file.h"
+#include "rlAssets_pack.h"
+#include "rlAssets_index.h"
+#include "rlAssets_platforms.h"
+#include "rlAssets_workers.h"
+#include "rlAssets_cache.h"
+#include "rlAssets_binary.h"
+#include "rlAssets_stats.h"
+#include "rlAssets_pool.h"
+
+std::shared_ptr<miniz_cpp::zip_file> OpenZipArchive(const std::string& archivePath);
+std::shared_ptr<rlas_PackFile> OpenPackArchive(const std::string& archivePath);
+bool IsPackFile(const std::string& name);
+
+// An archive on disk, either a zip or an rlAssets pack, the archive is opened the first time data is read from it
+class rlas_ArchiveFile
+{
+public:
+    rlas_ArchiveFile(const std::string& path) : Path(path), IsPack(IsPackFile(path))
+    {
+        rlas_GetFileStamp(path.c_str(), &Stamp);
+    }
+
+    rlas_ArchiveFile(const std::string& path, const std::shared_ptr<miniz_cpp::zip_file>& file) : rlas_ArchiveFile(path)
+    {
+        File = file;
+    }
+
+    rlas_ArchiveFile(const std::string& path, const std::shared_ptr<rlas_PackFile>& pack) : rlas_ArchiveFile(path)
+    {
+        Pack = pack;
+    }
+
+    // returns nullptr if the archive can not be opened or is a pack
+    std::shared_ptr<miniz_cpp::zip_file> Open()
+    {
+        std::lock_guard<std::mutex> lock(Lock);
+        if (File == nullptr && !Failed && !IsPack)
+        {
+            try
+            {
+                File = OpenZipArchive(Path);
+            }
+            catch (...)
+            {
+                Failed = true;
+            }
+        }
+        return File;
+    }
+
+    // returns nullptr if the pack can not be opened or is a zip
+    std::shared_ptr<rlas_PackFile> OpenPack()
+    {
+        std::lock_guard<std::mutex> lock(Lock);
+        if (Pack == nullptr && !Failed && IsPack)
+        {
+            try
+            {
+                Pack = OpenPackArchive(Path);
+            }
+            catch (...)
+            {
+                Failed = true;
+            }
+        }
+        return Pack;
+    }
+
+    const std::string Path;
+    const bool IsPack;
+    rlas_FileStamp Stamp;
+    std::string RelPath;    // where the entries of a tracked archive are, only used under the mount lock
+    uint32_t Mount = 0;
+
+private:
+    std::mutex Lock;
+    std::shared_ptr<miniz_cpp::zip_file> File;
+    std::shared_ptr<rlas_PackFile> Pack;
+    bool Failed = false;
+};
 
 typedef struct
 {
     std::string RelativeName;
     std::string PathOnDisk;
-    std::shared_ptr<miniz_cpp::zip_file> ArchiveFile;
-    miniz_cpp::zip_info ArchiveInfo;
+    std::shared_ptr<rlas_ArchiveFile> ArchiveFile;
+    miniz_cpp::zip_info ArchiveInfo;    // for packs only the file name and size are set
+    uint32_t PackEntry = 0;
+    uint32_t Mount = 0;     // the mount that added the asset, a later mount overrides an earlier one
+    rlas_FileStamp Stamp = { 0, 0 };  // files only, taken when the file was indexed
+    mutable rlas_AssetCounters Counters;
 }rlas_AssetMeta;
 
-typedef std::map<std::string, rlas_AssetMeta> MetaMap;
-typedef std::map<std::string, std::string> TempMap;
+typedef std::shared_ptr<const rlas_AssetMeta> AssetPtr;
+typedef rlas_PathIndex<AssetPtr> MetaMap;
+typedef struct
+{
+    std::string Path;
+    int MemoryFile = -1;    // the handle of the memory file holding the data, -1 for files on disk
+    bool Keep = false;      // cached extractions stay on disk after cleanup
+}rlas_TempFile;
 
-MetaMap AssetMap;
-TempMap TempFiles;
+typedef std::map<std::string, rlas_TempFile> TempMap;
 
-std::vector<std::string> AssetRootPaths;
+// a directory or archive of a lazily indexed resource path that has not been read yet
+typedef struct
+{
+    std::string Path;       // on disk, directories end with a delimiter
+    std::string RelPath;    // the virtual directory it is read into, ends with '/'
+    uint32_t Mount = 0;
+    bool IsArchive = false;
+}rlas_LazySource;
 
-std::string AssetTempPath;
+// A lazily indexed directory, with every resource path that has it. It is read into a table of its own the first time a
+// lookup reaches it, the same way a mount is, so reading one does not copy the asset table, see ReadLazyDirectory.
+struct rlas_LazyDirectory;
+typedef std::shared_ptr<rlas_LazyDirectory> LazyPtr;
 
-unsigned char* LoadBinFile(const char* fileName, unsigned int* bytesRead);      // FileIO: Load binary data
-char* LoadTextFile(const char* fileName);                                       // FileIO: Load text data
+// keyed by the virtual directory without a trailing '/', the same directory can come from more than one resource path
+typedef rlas_PathIndex<LazyPtr> LazyMap;
+
+struct rlas_MountPoint;
+typedef std::shared_ptr<rlas_MountPoint> MountPtr;
+
+// The assets of the resource paths and archives, or of one mount. A table is never changed once it is published,
+// adding a path builds a new table and swaps it in, so any number of threads can look up assets while another thread
+// adds one. Assets are shared between tables, so the strings of an asset stay valid until it is replaced or cleaned up.
+// The one exception is a lazy directory, which is read into its own table once and only then marked as ready.
+struct rlas_AssetTable
+{
+    MetaMap Assets;
+    rlas_DirectoryTree Tree;
+    LazyMap Lazy;
+    rlas_PathIndex<uint32_t> Pending;   // the lazy directories at or below each directory, so checking a whole tree is one lookup
+};
 
-std::string ToUpper(const char* c)
+struct rlas_LazyDirectory
 {
-    if (c == nullptr)
-        return std::string();
+    std::vector<rlas_LazySource> Sources;
+    std::atomic<bool> Ready;    // set once under the mount lock, after which the directory is never changed
+    rlas_AssetTable Table;      // only read after Ready, holds lazy directories of its own for the sub directories found
 
-    std::string upperPath = c;
-    for (auto& c : upperPath)
-        c = toupper(c);
+    rlas_LazyDirectory() : Ready(false) {}
+};
 
-    return upperPath;
-}
+typedef std::shared_ptr<const rlas_AssetTable> TablePtr;
 
-void rlas_Cleanup()
+// Everything a lookup reads, the asset table and the mounts layered over it. Layers are published the same way as tables,
+// but they only hold pointers, so mounting or unmounting shares the asset table and every other mount with the layers before.
+struct rlas_AssetLayers
 {
-    AssetRootPaths.clear();
-    AssetMap.clear();
+    TablePtr Table;
+    std::vector<MountPtr> Mounts;   // in override order, the highest priority first and the latest first within a priority
+    uint64_t Generation = 0;        // set when the layers are published, no two published layers share one
+    size_t LazyItems = 0;           // the assets and lazy directories in the lazy directory tables read since Table was built, plus one for each table
+};
 
-    for (auto& file : TempFiles)
-    {
-        try
-        {
-            remove(file.second.c_str());
-        }
-        catch (...)
-        {
+// A directory or archive mounted at a virtual prefix with rlas_Mount. Its files are kept in a table of their own that is
+// read the first time a lookup reaches the prefix, so mounting and unmounting only change the mount list and unmounting
+// frees nothing but the mount itself. A mount can hide files of the layers below it with a tombstone list, see LoadMount.
+struct rlas_MountPoint
+{
+    uint32_t Id = 0;            // from the mount count, so mounts and resource paths added at the same priority override in the order they were added
+    int Priority = 0;           // resource paths and archives added with the other calls have priority 0
+    std::string Source;         // directories end with a delimiter
+    std::string Prefix;         // ends with '/', empty for the root
+    std::once_flag Loaded;
+    std::atomic<bool> Ready;
+    rlas_AssetTable Table;      // only read after Loaded
+    rlas_PathIndex<char> Removed;   // tombstones, every path here and below is hidden from the layers under this one, only read after Loaded
 
-        }
-    }
+    rlas_MountPoint() : Ready(false) {}
+};
 
-    TempFiles.clear();
-}
+typedef std::shared_ptr<const rlas_AssetLayers> LayersPtr;
 
-void rlas_SetTempPath(const char* path)
+LayersPtr MakeEmptyLayers()
 {
-    if (path == nullptr)
-        AssetTempPath.clear();
-    else
-        AssetTempPath = path;
+    std::shared_ptr<rlas_AssetLayers> layers = std::make_shared<rlas_AssetLayers>();
+    layers->Table = std::make_shared<rlas_AssetTable>();
+    return layers;
 }
 
-void rlas_SetAssetRootPath(const char* path, bool relativeToApp)
-{
-    SetLoadFileDataCallback(LoadBinFile);
-    SetLoadFileTextCallback(LoadTextFile);
-
-    AssetRootPaths.clear();
+// only accessed with std::atomic_load and std::atomic_store
+LayersPtr AssetLayers = MakeEmptyLayers();
 
-    if (relativeToApp)
-    {
-        std::string appPath = rlas_GetApplicationBasePath();
-        if (path != nullptr)
-        {
-            appPath += path;
-            appPath += PathDelim;
-        }
+std::atomic<uint64_t> LayerGenerations(0);
 
-        rlas_AddAssetResourcePath(appPath.c_str());
-    }
-    else
-    {
-        rlas_AddAssetResourcePath(path);
-    }
-}
+// held by everything that changes the asset layers or the mount state below, lookups never take it
+std::mutex MountLock;
 
-const char* rlas_GetAssetRootPath()
+// an interned virtual path, its handle is its place in the handle table plus one
+struct rlas_HandleSlot
 {
-    if (AssetRootPaths.size() == 0)
-        return nullptr;
+    std::string Path;
+    std::atomic<uint64_t> Resolved;     // the table generation the asset was last found in (high half) and its item index plus one, 0 for a miss (low half)
+};
 
-    return AssetRootPaths[0].c_str();
-}
+static const uint32_t HandleChunkShift = 10;
+static const uint32_t HandleChunkSize = 1 << HandleChunkShift;
+static const uint32_t HandleChunkCount = 4096;
 
-void AddZipArchive(const char* archiveName, const std::string& archivePath, const std::string& relRootPath)
-{
-    std::string archiveRelPath = relRootPath;
-    if (archiveName != nullptr)
-        archiveRelPath += archiveName + std::string("/");
+// interning a new path takes the lock, using a handle never does
+// slots are allocated in chunks that never move, so a handle stays valid while more paths are interned
+std::mutex HandleLock;
+rlas_PathIndex<uint32_t> HandleNames;
+std::unique_ptr<rlas_HandleSlot[]> HandleChunks[HandleChunkCount];
+std::atomic<rlas_HandleSlot*> HandleSlots[HandleChunkCount];
+std::atomic<uint32_t> HandleCount(0);
 
-    std::shared_ptr<miniz_cpp::zip_file> archive = std::make_shared<miniz_cpp::zip_file>(archivePath.c_str());
+std::vector<std::string> AssetRootPaths;
 
-    for (auto& info : archive->infolist())
-    {
-        if (info.file_size == 0)
-            continue;
+typedef struct
+{
+    std::string Path;
+    std::string RelPath;
+    uint32_t Mount = 0;
+    rlas_FileStamp Stamp;
+    int Watch = -1;     // -1 until the directory is watched, -2 if it could not be
+}rlas_IndexedDirectory;
 
-        std::string assetRelPath = archiveRelPath + info.filename;
+// counts resource paths and archives as they are added
+uint32_t MountCount = 0;
 
-        rlas_AssetMeta meta;
-        meta.RelativeName = assetRelPath;
-        meta.PathOnDisk = archivePath;
-        meta.ArchiveFile = archive;
-        meta.ArchiveInfo = info;
+// every directory and archive read into the asset map, used to check if a manifest is still valid
+std::vector<rlas_IndexedDirectory> IndexedDirectories;
+std::vector<std::shared_ptr<rlas_ArchiveFile>> IndexedArchives;
 
-        std::string upperPath = ToUpper(assetRelPath.c_str());
+std::string AssetManifestPath;
 
-        AssetMap[upperPath] = meta;
-    }
-}
+// held while extracting, guards the temp path, extraction mode and temp files
+std::mutex TempLock;
+std::string AssetTempPath;
+rlas_ExtractionMode ExtractionMode = RLAS_EXTRACT_TEMP_FILES;
+TempMap TempFiles;
 
-void RecurseAddFiles(const std::string& root, const std::string& relRootPath)
-{
-    int count = 0;
-    char** path = GetDirectoryFiles(root.c_str(), &count);
+std::atomic<bool> MapArchives(true);
+std::atomic<bool> LazyIndexing(false);
 
-    std::vector<std::string> subDirs;
-    for (int i = 0; i < count; ++i)
-    {
-        if (path[i] == nullptr || path[i][0] == '.')
-            continue;
+rlas_DataCache ArchiveCache;
 
-        std::string relPath = relRootPath + path[i];
-        std::string fullPath = root + path[i];
-        if (!DirectoryExists(fullPath.c_str()) && FileExists(fullPath.c_str()))
-        {
-            if (IsFileExtension(path[i], ".zip"))
-            {
-                AddZipArchive(GetFileNameWithoutExt(path[i]), fullPath, relRootPath);
-            }
-            else
-            {
-                std::string upperPath = ToUpper(relPath.c_str());
+std::atomic<bool> StatsEnabled(false);
+rlas_StatCounters Stats;
 
-                rlas_AssetMeta meta;
-                meta.RelativeName = relPath;
-                meta.PathOnDisk = fullPath;
-                meta.ArchiveFile = nullptr;
+rlas_BufferPool TransientBuffers;
 
-                AssetMap[upperPath] = meta;
-            }
-        }
-        else
-        {
-            subDirs.push_back(path[i]);
+rlas_WorkerPool AssetWorkers;
 
-        }
-    }
-    ClearDirectoryFiles();
+struct rlas_MappedArchive
+{
+    rlas_FileMapping Mapping;
+    miniz_cpp::zip_file Archive;
 
-    for (auto subDir : subDirs)
+    ~rlas_MappedArchive()
     {
-        RecurseAddFiles(root + subDir + PathDelim, relRootPath + subDir + "/");
+        Archive.reset();    // the reader must be shut down before the memory goes away
+        rlas_UnmapFile(&Mapping);
     }
+};
+
+LayersPtr GetAssetLayers()
+{
+    return std::atomic_load(&AssetLayers);
 }
 
-void rlas_AddAssetResourcePath(const char* path)
+TablePtr GetAssetTable()
 {
-    if (path == nullptr)
-        return;
+    return GetAssetLayers()->Table;
+}
 
-    std::string root = path;
+void SetAsset(rlas_AssetTable& table, const std::string& relPath, const AssetPtr& meta);
+void MergeLazyDirectories(rlas_AssetTable& table, const LazyMap& lazy);
 
-    AssetRootPaths.emplace_back(root);
+// starts a new table from the current one with the tables of the lazy directories read since merged into it,
+// the caller must hold the mount lock
+std::shared_ptr<rlas_AssetTable> CopyAssetTable()
+{
+    const rlas_AssetTable& current = *GetAssetTable();
 
-    RecurseAddFiles(root, "");
+    std::shared_ptr<rlas_AssetTable> table = std::make_shared<rlas_AssetTable>();
+    table->Assets = current.Assets;
+    table->Tree = current.Tree;
+    MergeLazyDirectories(*table, current.Lazy);
+    return table;
 }
 
-void rlas_AddAssetResourceArchive(const char* path, bool relativeToApp)
+// the caller must hold the mount lock, lazyItems goes with the table and is 0 for a table that was just built
+LayersPtr PublishAssetLayers(const TablePtr& table, const std::vector<MountPtr>& mounts, size_t lazyItems = 0)
 {
-    std::string pathToUse = path;
+    std::shared_ptr<rlas_AssetLayers> layers = std::make_shared<rlas_AssetLayers>();
+    layers->Table = table;
+    layers->Mounts = mounts;
+    layers->LazyItems = lazyItems;
+    layers->Generation = ++LayerGenerations;
+    std::atomic_store(&AssetLayers, LayersPtr(layers));
+    return layers;
+}
 
-    if (relativeToApp)
+// swaps in a new asset table under the current mounts
+LayersPtr PublishAssetTable(const std::shared_ptr<rlas_AssetTable>& table)
+{
+    return PublishAssetLayers(table, GetAssetLayers()->Mounts);
+}
+
+LayersPtr IndexLazyParents(LayersPtr layers, const char* path);
+const rlas_AssetTable& LoadMount(rlas_MountPoint& mount);
+
+// case insensitive, a path always has the empty prefix
+bool HasPathPrefix(const char* path, const std::string& prefix)
+{
+    for (size_t i = 0; i < prefix.size(); ++i)
     {
-        pathToUse = rlas_GetApplicationBasePath();
-        if (path != nullptr)
-        {
-            pathToUse += path;
-        }
+        if (rlas_FoldPathChar(path[i]) != rlas_FoldPathChar(prefix[i]))
+            return false;
     }
-    AddZipArchive(nullptr, pathToUse, "");
+    return true;
 }
 
-const char* rlas_GetAssetPath(const char* path)
+bool MountOverrides(const rlas_MountPoint& mount, const rlas_AssetMeta& meta)
 {
-    std::string upperPath = ToUpper(path);
-    MetaMap::iterator itr = AssetMap.find(upperPath);
-    if (itr == AssetMap.end())
-        return nullptr;
-
-    if (itr->second.ArchiveFile != nullptr)
-    {
-        if (TempFiles.find(upperPath) == TempFiles.end())
-        {
-            if (AssetTempPath.empty())  // no place to extract, return null
-                return nullptr;
+    return mount.Priority > 0 || (mount.Priority == 0 && mount.Id > meta.Mount);
+}
 
-            std::string tempName = itr->second.RelativeName;
-            std::replace(tempName.begin(), tempName.end(), '/', '_');
-            tempName = AssetTempPath + tempName;
+// where an asset was found, the mount is 0 for the asset map or the place in the mount list plus one
+// and LazyTableLocation for the table of a lazy directory, which has no place to give
+static const uint32_t LazyTableLocation = 0xFFFFFFFFu;
 
-            std::fstream stream(tempName, std::ios::binary | std::ios::out);
-            stream << itr->second.ArchiveFile->open(itr->second.ArchiveInfo).rdbuf();
+struct rlas_AssetLocation
+{
+    uint32_t Mount = 0;
+    size_t Item = 0;
+};
 
-            TempFiles[upperPath] = tempName;
-        }
+// true if a mount has a tombstone for a path or one of its directories
+bool MountRemoves(const rlas_MountPoint& mount, const char* path)
+{
+    if (mount.Removed.Size() == 0)
+        return false;
 
-        return TempFiles[upperPath].c_str();
+    for (const char* slash = strchr(path, '/'); slash != nullptr; slash = strchr(slash + 1, '/'))
+    {
+        if (mount.Removed.Find(path, slash - path) != nullptr)
+            return true;
     }
-
-    return itr->second.PathOnDisk.c_str();
+    return mount.Removed.Find(path) != nullptr;
 }
 
-int rlas_AppendPath(const char* path, const char* subpath, char* destination, int lenght)
+// calls a function with every lazy directory on the way to a path, with the ones found in the tables of those that have been read,
+// the function returns false to stop, from is where in the path to start looking for the next directory
+template<class F>
+bool VisitLazyParents(const LazyMap& lazy, const char* path, const char* from, F& function)
 {
-    std::string p = path;
-    std::string sp = subpath;
-    std::string result = p + PathDelim + sp;
+    if (lazy.Size() == 0)
+        return true;
 
-    if (result.size() > lenght - 1)
-        return -1;
+    for (const char* slash = strchr(from, '/'); slash != nullptr; slash = strchr(slash + 1, '/'))
+    {
+        const LazyPtr* directory = lazy.Find(path, slash - path);
+        if (directory == nullptr)
+            continue;
 
-#ifdef _WIN32
-    strncpy_s(destination, lenght, result.c_str(), result.size());
-#else
-    strncpy(destination, result.c_str(), result.size());
-#endif //_WIN32
-    destination[result.size()] = '\0';
+        if (!function(**directory))
+            return false;
 
-    return static_cast<int>(result.size());
+        if ((*directory)->Ready.load(std::memory_order_acquire) && !VisitLazyParents((*directory)->Table.Lazy, path, slash + 1, function))
+            return false;
+    }
+    return true;
 }
 
-int rlas_GetAssetsInPath(const char* path, bool recursive, char* results[])
+// looks a path up in the asset map and then in every mount with a matching prefix that would override what was found,
+// the first of those mounts that has the path wins and a tombstone in one hides the path in everything below it
+// the path is hashed once for the asset map and all the mounts
+const AssetPtr* FindInTable(const rlas_AssetLayers& layers, const char* path, rlas_AssetLocation* location = nullptr)
 {
-    int count = 0;
+    size_t length = strlen(path);
+    uint64_t hash = rlas_HashPath(path, length);
 
-    std::string upperPath = ToUpper(path);
+    const rlas_AssetTable& table = *layers.Table;
+    size_t item = 0;
+    const AssetPtr* found = nullptr;
+    if (table.Assets.IndexOf(path, length, hash, item))
+    {
+        found = &table.Assets.ItemAt(item);
+        if (location != nullptr)
+            location->Item = item;
+    }
 
-    for (auto& asset : AssetMap)
+    // the tables of the lazy directories read on the way, the same as if they had been merged into the asset map
+    auto visit = [&](const rlas_LazyDirectory& directory)
     {
-        if (asset.first.rfind(upperPath) == 0)
+        if (directory.Ready.load(std::memory_order_acquire) && directory.Table.Assets.IndexOf(path, length, hash, item))
         {
-            bool isFile = asset.first.find_first_of('/', upperPath.length()) > asset.first.size();
-            if (isFile || recursive)
+            const AssetPtr* lazy = &directory.Table.Assets.ItemAt(item);
+            if (found == nullptr || (*lazy)->Mount >= (*found)->Mount)
             {
-                if (results != nullptr)
-                    results[count] = (char*)asset.second.RelativeName.c_str();
-                ++count;
+                found = lazy;
+                if (location != nullptr)
+                    location->Mount = LazyTableLocation;
             }
         }
-    }
-
-    return count;
-}
-
-bool rlas_FileIsArchive(const char* path)
-{
-    MetaMap::iterator itr = AssetMap.find(ToUpper(path));
-    if (itr == AssetMap.end())
-        return false;
+        return true;
+    };
+    VisitLazyParents(table.Lazy, path, path, visit);
 
-    return itr->second.ArchiveFile != nullptr;
-}
+    for (size_t i = 0; i < layers.Mounts.size(); ++i)
+    {
+        rlas_MountPoint& mount = *layers.Mounts[i];
 
-void* ReadFileContents(const char* fileName, unsigned int* bytesRead, bool binary)
-{
-    void* data = NULL;
-    *bytesRead = 0;
+        // the mounts are in override order, so once one can not override the asset found none of the rest can
+        if (found != nullptr && !MountOverrides(mount, **found))
+            break;
 
-    if (fileName != NULL)
-    {
-        FILE* file = fopen(fileName, binary ? "rb" : "rt");
+        if (!HasPathPrefix(path, mount.Prefix))
+            continue;
 
-        if (file != NULL)
+        const rlas_AssetTable& mounted = LoadMount(mount);
+        if (mounted.Assets.IndexOf(path, length, hash, item))
         {
-            fseek(file, 0, SEEK_END);
-            int size = ftell(file);
-            fseek(file, 0, SEEK_SET);
-
-            if (size > 0)
+            if (location != nullptr)
             {
-                data = MemAlloc(size * sizeof(unsigned char));
-
-                // NOTE: fread() returns number of read elements instead of bytes, so we read [1 byte, size elements]
-                *bytesRead = (unsigned int)fread(data, sizeof(unsigned char), size, file);
+                location->Mount = (uint32_t)i + 1;
+                location->Item = item;
             }
-            fclose(file);
+            return &mounted.Assets.ItemAt(item);
         }
+
+        if (MountRemoves(mount, path))
+            return nullptr;
     }
 
-    return data;
+    return found;
 }
 
-unsigned char* LoadBinFile(const char* fileName, unsigned int* bytesRead)
+// may read a mount the first time it is reached, see LoadMount for what that allows
+// a lookup by path is not cached, it costs one hash and a probe of the asset map and of each mount that could override it,
+// a cache keyed by path costs about the same to check and loses once more paths are in use than it holds, handles are the
+// cached lookup, see FindAsset(rlas_AssetHandle)
+AssetPtr FindAsset(const char* path)
 {
-    MetaMap::iterator itr = AssetMap.find(ToUpper(fileName));
-    if (itr == AssetMap.end())
+    LayersPtr layers = GetAssetLayers();
+    if (layers->Table->Lazy.Size() != 0 && path != nullptr)
+        layers = IndexLazyParents(layers, path);
+
+    const AssetPtr* meta = path == nullptr ? nullptr : FindInTable(*layers, path);
+
+    rlas_AddStat(Stats.Lookups);
+    if (meta == nullptr)
     {
-        *bytesRead = 0;
-        if (FileExists(fileName))
-        {
-            return (unsigned char*)ReadFileContents(fileName, bytesRead, true);
-        }
+        rlas_AddStat(Stats.LookupMisses);
         return nullptr;
     }
 
-    if (itr->second.ArchiveFile != nullptr)
-    {
-        *bytesRead = (unsigned int)itr->second.ArchiveInfo.file_size;
-        void* buffer = (unsigned char*)MemAlloc((unsigned int)itr->second.ArchiveInfo.file_size);
-        itr->second.ArchiveFile->readBin(itr->second.ArchiveInfo, buffer);
+    rlas_AddStat((*meta)->Counters.Lookups);
+    return *meta;
+}
 
-        return (unsigned char*)buffer;
-    }
+rlas_HandleSlot* GetHandleSlot(rlas_AssetHandle handle)
+{
+    if (handle == 0 || handle > HandleCount.load(std::memory_order_acquire))
+        return nullptr;
 
-    return (unsigned char*)ReadFileContents(itr->second.PathOnDisk.c_str(), bytesRead, true);
+    uint32_t index = handle - 1;
+    return &HandleSlots[index >> HandleChunkShift].load(std::memory_order_acquire)[index & (HandleChunkSize - 1)];
 }
 
-char* LoadTextFile(const char* fileName)
+// the low half of a resolved handle is the mount in the top 8 bits and the item index plus one below them
+static const uint32_t HandleItemBits = 24;
+static const uint32_t HandleItemMask = (1 << HandleItemBits) - 1;
+
+// where a handle resolved to is kept with the generation of the layers it was found in, so until the next change
+// a handle lookup is a couple of loads, after one the path is resolved through the layers again and the handle keeps working
+AssetPtr FindAsset(rlas_AssetHandle handle)
 {
-    MetaMap::iterator itr = AssetMap.find(ToUpper(fileName));
-    if (itr == AssetMap.end())
+    rlas_HandleSlot* slot = GetHandleSlot(handle);
+    if (slot == nullptr)
+        return nullptr;
+
+    LayersPtr layers = GetAssetLayers();
+    const AssetPtr* meta = nullptr;
+    uint64_t resolved = slot->Resolved.load(std::memory_order_acquire);
+    if ((uint32_t)(resolved >> 32) == (uint32_t)layers->Generation)
     {
-        if (FileExists(fileName))
+        uint32_t mount = (uint32_t)resolved >> HandleItemBits;
+        uint32_t item = (uint32_t)resolved & HandleItemMask;
+        if (item != 0)
+            meta = &(mount == 0 ? *layers->Table : layers->Mounts[mount - 1]->Table).Assets.ItemAt(item - 1);
+    }
+    else
+    {
+        if (layers->Table->Lazy.Size() != 0)
+            layers = IndexLazyParents(layers, slot->Path.c_str());
+
+        rlas_AssetLocation location;
+        meta = FindInTable(*layers, slot->Path.c_str(), &location);
+
+        // an asset past what fits in the low half is looked up by path every time, one in the table of a lazy directory
+        // until the tables are merged
+        if (meta == nullptr || (location.Mount <= (0xFFFFFFFFu >> HandleItemBits) && location.Item < HandleItemMask))
         {
-            unsigned int bytesRead = 0;
-            return (char*)ReadFileContents(fileName, &bytesRead, false);
+            uint32_t item = meta == nullptr ? 0 : (location.Mount << HandleItemBits) | ((uint32_t)location.Item + 1);
+            slot->Resolved.store(((uint64_t)(uint32_t)layers->Generation << 32) | item, std::memory_order_release);
         }
-        return nullptr;
     }
 
-    if (itr->second.ArchiveFile != nullptr)
+    rlas_AddStat(Stats.Lookups);
+    if (meta == nullptr)
     {
-        std::string data = itr->second.ArchiveFile->read(itr->second.ArchiveInfo);
-        char* buffer = (char*)MemAlloc((unsigned int)data.size() + 1);
-        memcpy(buffer, data.c_str(), data.size());
-        buffer[data.size()] = '\0';
-
-        return buffer;
+        rlas_AddStat(Stats.LookupMisses);
+        return nullptr;
     }
-    unsigned int bytesRead = 0;
-    return (char*)ReadFileContents(itr->second.PathOnDisk.c_str(), &bytesRead, false);
+
+    rlas_AddStat((*meta)->Counters.Lookups);
+    return *meta;
 }
 
-unsigned int rlas_GetFileSize(const char* path)
+void SetAsset(rlas_AssetTable& table, const std::string& relPath, const AssetPtr& meta)
 {
-    MetaMap::iterator itr = AssetMap.find(ToUpper(path));
-    if (itr == AssetMap.end())
-        return 0;
+    const AssetPtr* current = table.Assets.Find(relPath.c_str());
+    if (current != nullptr && (*current)->Mount > meta->Mount)
+        return;
 
-    if (itr->second.ArchiveFile != nullptr)
-        return (unsigned int)itr->second.ArchiveInfo.file_size;
+    size_t count = table.Assets.Size();
+    table.Assets.Set(relPath, meta);
 
-    unsigned int size = 0;
+    // a path that was already in the map keeps its place in the tree
+    if (table.Assets.Size() != count)
+        table.Tree.AddFile(relPath, (uint32_t)count);
+}
+
+void RemoveAsset(rlas_AssetTable& table, const std::string& relPath)
+{
+    size_t index = 0;
+    if (!table.Assets.Remove(relPath, index))
+        return;
+
+    table.Tree.RemoveFile(relPath, (uint32_t)index);
+
+    // the last asset was moved into the removed one's place
+    if (index < table.Assets.Size())
+        table.Tree.MoveFile(table.Assets.NameAt(index), (uint32_t)table.Assets.Size(), (uint32_t)index);
+}
+
+unsigned char* LoadBinFile(const char* fileName, unsigned int* bytesRead);      // FileIO: Load binary data
+char* LoadTextFile(const char* fileName);                                       // FileIO: Load text data
+bool LoadAssetManifest(const char* fileName, const std::string* requiredRoot);
 
-    if (!itr->second.PathOnDisk.empty())
+void AddResourcePath(rlas_AssetTable& table, const std::string& root);
+bool SaveAssetManifest(const char* fileName);
+void WatchIndexedDirectories();
+void ResetDirectoryWatcher();
+void CancelPrefetches();
+
+void rlas_Cleanup()
+{
+    std::lock_guard<std::mutex> mountLock(MountLock);
+
+    AssetRootPaths.clear();
+    PublishAssetLayers(std::make_shared<rlas_AssetTable>(), std::vector<MountPtr>());
+    IndexedDirectories.clear();
+    IndexedArchives.clear();
+    ResetDirectoryWatcher();
+
+    std::lock_guard<std::mutex> tempLock(TempLock);
+    for (auto& file : TempFiles)
     {
-#ifdef _WIN32
-        FILE* file = nullptr;
-        fopen_s(&file, itr->second.PathOnDisk.c_str(), "rb");
-#else
-        FILE* file = fopen(itr->second.PathOnDisk.c_str(), "rb");
-#endif //_WIN32
+        if (file.second.MemoryFile >= 0)
+        {
+            rlas_CloseMemoryFile(file.second.MemoryFile);
+            continue;
+        }
+
+        if (file.second.Keep)
+            continue;
 
-        if (file != nullptr)
+        try
         {
-            // WARNING: On binary streams SEEK_END could not be found,
-            // using fseek() and ftell() could not work in some (rare) cases
-            fseek(file, 0, SEEK_END);
-            size = ftell(file);
-            fseek(file, 0, SEEK_SET);
-            fclose(file);
+            remove(file.second.Path.c_str());
+        }
+        catch (...)
+        {
+
         }
     }
 
-    return size;
-}
\ No newline at end of file
+    TempFiles.clear();
+
+    CancelPrefetches();
+    ArchiveCache.Clear();
+}
+
+void rlas_SetTempPath(const char* path)
+{
+    std::lock_guard<std::mutex> lock(TempLock);
+
+    if (path == nullptr)
+        AssetTempPath.clear();
+    else
+        AssetTempPath = path;
+}
+
+bool rlas_SetExtractionMode(rlas_ExtractionMode mode)
+{
+    if (mode == RLAS_EXTRACT_MEMORY_FILES)
+    {
+        // make sure the OS has memory files before switching to them
+        std::string path;
+        int probe = rlas_CreateMemoryFile("rlas_probe", nullptr, 0, path);
+        if (probe < 0)
+            return false;
+        rlas_CloseMemoryFile(probe);
+    }
+    else if (mode != RLAS_EXTRACT_TEMP_FILES && mode != RLAS_EXTRACT_CACHED_FILES)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(TempLock);
+    ExtractionMode = mode;
+    return true;
+}
+
+void rlas_SetAssetRootPath(const char* path, bool relativeToApp)
+{
+    SetLoadFileDataCallback(LoadBinFile);
+    SetLoadFileTextCallback(LoadTextFile);
+
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    AssetRootPaths.clear();
+
+    std::string rootPath;
+    if (relativeToApp)
+    {
+        rootPath = rlas_GetApplicationBasePath();
+        if (path != nullptr)
+        {
+            rootPath += path;
+            rootPath += PathDelim;
+        }
+    }
+    else if (path != nullptr)
+    {
+        rootPath = path;
+    }
+    else
+    {
+        return;
+    }
+
+    // a manifest describes the whole asset map, so it can only stand in for the scan when nothing else has been added
+    bool useManifest = !AssetManifestPath.empty() && GetAssetTable()->Assets.Size() == 0;
+    if (useManifest && LoadAssetManifest(AssetManifestPath.c_str(), &rootPath))
+        return;
+
+    std::shared_ptr<rlas_AssetTable> table = CopyAssetTable();
+    AddResourcePath(*table, rootPath);
+    PublishAssetTable(table);
+    WatchIndexedDirectories();
+
+    if (useManifest)
+        SaveAssetManifest(AssetManifestPath.c_str());
+}
+
+const char* rlas_GetAssetRootPath()
+{
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    if (AssetRootPaths.size() == 0)
+        return nullptr;
+
+    return AssetRootPaths[0].c_str();
+}
+
+std::shared_ptr<miniz_cpp::zip_file> OpenZipArchive(const std::string& archivePath)
+{
+    rlas_StatTimer timer(Stats.FileOpenNanoseconds, &Stats.FileOpens);
+
+    if (MapArchives)
+    {
+        std::shared_ptr<rlas_MappedArchive> mapped = std::make_shared<rlas_MappedArchive>();
+        if (rlas_MapFile(archivePath.c_str(), &mapped->Mapping))
+        {
+            mapped->Archive.load_view(mapped->Mapping.Data, mapped->Mapping.Size);
+
+            // share ownership with the mapping so it lives as long as any asset that uses the archive
+            return std::shared_ptr<miniz_cpp::zip_file>(mapped, &mapped->Archive);
+        }
+    }
+
+    return std::make_shared<miniz_cpp::zip_file>(archivePath);
+}
+
+std::shared_ptr<rlas_PackFile> OpenPackArchive(const std::string& archivePath)
+{
+    rlas_StatTimer timer(Stats.FileOpenNanoseconds, &Stats.FileOpens);
+
+    std::shared_ptr<rlas_PackFile> pack = std::make_shared<rlas_PackFile>();
+    if (!pack->Open(archivePath, MapArchives))
+        throw std::runtime_error("bad pack");
+
+    return pack;
+}
+
+std::shared_ptr<rlas_AssetMeta> MakeZipAsset(const std::shared_ptr<rlas_ArchiveFile>& archive, const miniz_cpp::zip_info& info, const std::string& archiveRelPath, uint32_t mount)
+{
+    std::shared_ptr<rlas_AssetMeta> meta = std::make_shared<rlas_AssetMeta>();
+    meta->RelativeName = archiveRelPath + info.filename;
+    meta->PathOnDisk = archive->Path;
+    meta->ArchiveFile = archive;
+    meta->ArchiveInfo = info;
+    meta->Mount = mount;
+    return meta;
+}
+
+std::shared_ptr<rlas_AssetMeta> MakePackAsset(const std::shared_ptr<rlas_ArchiveFile>& archive, const rlas_PackFile& pack, uint32_t entry, const std::string& archiveRelPath, uint32_t mount)
+{
+    std::string name = pack.NameAt(entry);
+
+    std::shared_ptr<rlas_AssetMeta> meta = std::make_shared<rlas_AssetMeta>();
+    meta->RelativeName = archiveRelPath + name;
+    meta->PathOnDisk = archive->Path;
+    meta->ArchiveFile = archive;
+    meta->ArchiveInfo.filename = name;
+    meta->ArchiveInfo.file_size = (size_t)pack.EntryAt(entry).Size;
+    meta->ArchiveInfo.crc = pack.EntryAt(entry).Crc;
+    meta->PackEntry = entry;
+    meta->Mount = mount;
+    return meta;
+}
+
+void TrackArchive(const std::shared_ptr<rlas_ArchiveFile>& archive, const std::string& archiveRelPath, uint32_t mount)
+{
+    archive->RelPath = archiveRelPath;
+    archive->Mount = mount;
+    IndexedArchives.push_back(archive);
+}
+
+// tracked archives are part of the asset map, so they are saved in the manifest and followed by the watcher
+void AddArchiveEntries(rlas_AssetTable& table, const std::shared_ptr<rlas_ArchiveFile>& archive, const std::vector<miniz_cpp::zip_info>& entries, const std::string& archiveRelPath, uint32_t mount, bool track)
+{
+    if (track)
+        TrackArchive(archive, archiveRelPath, mount);
+
+    for (auto& info : entries)
+    {
+        if (info.file_size == 0)
+            continue;
+
+        std::shared_ptr<rlas_AssetMeta> meta = MakeZipAsset(archive, info, archiveRelPath, mount);
+        SetAsset(table, meta->RelativeName, meta);
+    }
+}
+
+void AddPackEntries(rlas_AssetTable& table, const std::shared_ptr<rlas_ArchiveFile>& archive, const std::string& archiveRelPath, uint32_t mount, bool track)
+{
+    if (track)
+        TrackArchive(archive, archiveRelPath, mount);
+
+    std::shared_ptr<rlas_PackFile> pack = archive->OpenPack();
+    if (pack == nullptr)
+        return;
+
+    for (uint32_t entry = 0; entry < pack->Count(); ++entry)
+    {
+        if (pack->EntryAt(entry).Size == 0)
+            continue;
+
+        std::shared_ptr<rlas_AssetMeta> meta = MakePackAsset(archive, *pack, entry, archiveRelPath, mount);
+        SetAsset(table, meta->RelativeName, meta);
+    }
+}
+
+// adds every entry of a zip or pack under a relative path, throws if the archive can not be read
+void AddArchiveFile(rlas_AssetTable& table, const std::string& archivePath, const std::string& archiveRelPath, uint32_t mount, bool track = true)
+{
+    if (IsPackFile(archivePath))
+    {
+        AddPackEntries(table, std::make_shared<rlas_ArchiveFile>(archivePath, OpenPackArchive(archivePath)), archiveRelPath, mount, track);
+        return;
+    }
+
+    std::shared_ptr<miniz_cpp::zip_file> archive = OpenZipArchive(archivePath);
+
+    AddArchiveEntries(table, std::make_shared<rlas_ArchiveFile>(archivePath, archive), archive->infolist(), archiveRelPath, mount, track);
+}
+
+bool HasExtension(const std::string& name, const char* extension)
+{
+    size_t len = strlen(extension);
+    if (name.size() <= len)
+        return false;
+
+    for (size_t i = 0; i < len; ++i)
+    {
+        if (rlas_FoldPathChar(name[name.size() - len + i]) != rlas_FoldPathChar(extension[i]))
+            return false;
+    }
+    return true;
+}
+
+bool IsZipFile(const std::string& name)
+{
+    return HasExtension(name, ".zip");
+}
+
+bool IsPackFile(const std::string& name)
+{
+    return HasExtension(name, ".rlpak");
+}
+
+bool IsArchiveFile(const std::string& name)
+{
+    return IsZipFile(name) || IsPackFile(name);
+}
+
+// archives are mounted as a directory named after the archive without its extension
+std::string ArchiveRelPath(const std::string& relPath)
+{
+    return relPath.substr(0, relPath.find_last_of('.')) + "/";
+}
+
+struct rlas_ScanItem
+{
+    std::string Name;
+    rlas_FileStamp Stamp;
+    std::shared_ptr<rlas_ArchiveFile> Archive;
+    std::vector<miniz_cpp::zip_info> ArchiveEntries;    // zips only, packs read their entries when they are added
+};
+
+struct rlas_ScanNode
+{
+    std::string Root;
+    std::string RelPath;
+    rlas_FileStamp Stamp;
+    std::vector<rlas_ScanItem> Files;
+    std::vector<std::unique_ptr<rlas_ScanNode>> SubDirs;
+};
+
+// Lists a directory tree across the worker threads
+// Directories and archives are read in parallel, but nothing is added to the asset map until the whole tree has been read,
+// so the results can be added in a fixed order and override the same way every time
+// The directories wait in a queue of the scan's own, the calling thread works through it and workers only help, so a scan is never
+// held up behind loads queued on the pool and can run on a worker thread without waiting on itself
+class rlas_DirectoryScan
+{
+public:
+    // an archive that can not be opened fails the scan, unless skipBrokenArchives leaves it out like a missing file
+    void Run(rlas_ScanNode& root, bool skipBrokenArchives = false)
+    {
+        // helpers that start after the scan is done only see the shared state, never the nodes
+        std::shared_ptr<State> state = std::make_shared<State>();
+        state->SkipBrokenArchives = skipBrokenArchives;
+        state->Nodes.push_back(&root);
+        state->Pending = 1;
+
+        int helpers = AssetWorkers.GetThreadCount();
+        for (int i = 0; i < helpers; ++i)
+            AssetWorkers.Push([state]() { Work(*state); });
+
+        Work(*state);
+
+        if (state->Error != nullptr)
+            std::rethrow_exception(state->Error);
+    }
+
+private:
+    struct State
+    {
+        std::mutex Lock;
+        std::condition_variable Wake;
+        std::deque<rlas_ScanNode*> Nodes;
+        int Pending = 0;                    // directories queued or being read
+        bool SkipBrokenArchives = false;
+        std::exception_ptr Error;
+    };
+
+    // reads queued directories until every directory of the tree has been read
+    static void Work(State& state)
+    {
+        std::unique_lock<std::mutex> lock(state.Lock);
+        for (;;)
+        {
+            state.Wake.wait(lock, [&state]() { return state.Pending == 0 || !state.Nodes.empty(); });
+            if (state.Nodes.empty())
+                return;
+
+            rlas_ScanNode* node = state.Nodes.front();
+            state.Nodes.pop_front();
+
+            lock.unlock();
+            ScanDirectory(state, *node);
+            lock.lock();
+
+            for (auto& subDir : node->SubDirs)
+                state.Nodes.push_back(subDir.get());
+
+            state.Pending += static_cast<int>(node->SubDirs.size()) - 1;
+            state.Wake.notify_all();
+        }
+    }
+
+    static void ScanDirectory(State& state, rlas_ScanNode& node)
+    {
+        try
+        {
+            // stamp before listing, so a change made during the scan makes the stamp out of date
+            rlas_GetFileStamp(node.Root.c_str(), &node.Stamp);
+
+            std::vector<rlas_DirectoryEntry> entries;
+            rlas_ListDirectory(node.Root.c_str(), entries, true);
+
+            std::sort(entries.begin(), entries.end(), [](const rlas_DirectoryEntry& a, const rlas_DirectoryEntry& b) { return a.Name < b.Name; });
+
+            for (auto& entry : entries)
+            {
+                if (entry.IsDirectory)
+                {
+                    rlas_ScanNode* subDir = new rlas_ScanNode();
+                    subDir->Root = node.Root + entry.Name + PathDelim;
+                    subDir->RelPath = node.RelPath + entry.Name + "/";
+                    node.SubDirs.emplace_back(subDir);
+                    continue;
+                }
+
+                rlas_ScanItem item;
+                item.Name = entry.Name;
+                item.Stamp = entry.Stamp;
+                try
+                {
+                    if (IsPackFile(entry.Name))
+                    {
+                        std::string archivePath = node.Root + entry.Name;
+                        item.Archive = std::make_shared<rlas_ArchiveFile>(archivePath, OpenPackArchive(archivePath));
+                    }
+                    else if (IsZipFile(entry.Name))
+                    {
+                        std::string archivePath = node.Root + entry.Name;
+                        std::shared_ptr<miniz_cpp::zip_file> archive = OpenZipArchive(archivePath);
+                        item.Archive = std::make_shared<rlas_ArchiveFile>(archivePath, archive);
+                        item.ArchiveEntries = archive->infolist();
+                    }
+                }
+                catch (...)
+                {
+                    if (!state.SkipBrokenArchives)
+                        throw;
+                    continue;
+                }
+                node.Files.push_back(std::move(item));
+            }
+        }
+        catch (...)
+        {
+            std::unique_lock<std::mutex> lock(state.Lock);
+            if (state.Error == nullptr)
+                state.Error = std::current_exception();
+        }
+    }
+};
+
+void AddLooseFile(rlas_AssetTable& table, const std::string& relPath, const std::string& fullPath, const rlas_FileStamp& stamp, uint32_t mount)
+{
+    std::shared_ptr<rlas_AssetMeta> meta = std::make_shared<rlas_AssetMeta>();
+    meta->RelativeName = relPath;
+    meta->PathOnDisk = fullPath;
+    meta->ArchiveFile = nullptr;
+    meta->Mount = mount;
+    meta->Stamp = stamp;
+
+    SetAsset(table, relPath, meta);
+}
+
+void AddScannedFiles(rlas_AssetTable& table, const rlas_ScanNode& node, uint32_t mount, bool track)
+{
+    if (track)
+    {
+        rlas_IndexedDirectory directory;
+        directory.Path = node.Root;
+        directory.RelPath = node.RelPath;
+        directory.Mount = mount;
+        directory.Stamp = node.Stamp;
+        IndexedDirectories.push_back(directory);
+    }
+
+    for (auto& item : node.Files)
+    {
+        std::string relPath = node.RelPath + item.Name;
+        std::string fullPath = node.Root + item.Name;
+
+        if (item.Archive != nullptr)
+        {
+            std::string archiveRelPath = ArchiveRelPath(relPath);
+            if (item.Archive->IsPack)
+                AddPackEntries(table, item.Archive, archiveRelPath, mount, track);
+            else
+                AddArchiveEntries(table, item.Archive, item.ArchiveEntries, archiveRelPath, mount, track);
+        }
+        else
+        {
+            AddLooseFile(table, relPath, fullPath, item.Stamp, mount);
+        }
+    }
+
+    for (auto& subDir : node.SubDirs)
+        AddScannedFiles(table, *subDir, mount, track);
+}
+
+void RecurseAddFiles(rlas_AssetTable& table, const std::string& root, const std::string& relRootPath, uint32_t mount, bool track = true, bool skipBrokenArchives = false)
+{
+    rlas_ScanNode rootNode;
+    rootNode.Root = root;
+    rootNode.RelPath = relRootPath;
+
+    rlas_DirectoryScan scan;
+    scan.Run(rootNode, skipBrokenArchives);
+
+    AddScannedFiles(table, rootNode, mount, track);
+}
+
+// counts a lazy directory added to or taken out of a table in the directory and every directory above it
+void CountPending(rlas_AssetTable& table, const std::string& directory, int change)
+{
+    size_t end = 0;
+    for (;;)
+    {
+        uint32_t* count = table.Pending.Find(directory.c_str(), end);
+        if (count == nullptr)
+            count = &table.Pending.Set(directory.substr(0, end), 0);
+        *count += change;
+
+        if (end == directory.size())
+            break;
+
+        end = directory.find('/', end + 1);
+        if (end == std::string::npos)
+            end = directory.size();
+    }
+}
+
+void AddLazySource(rlas_AssetTable& table, const rlas_LazySource& source)
+{
+    std::string name = source.RelPath.substr(0, source.RelPath.size() - 1);
+    LazyPtr* directory = table.Lazy.Find(name.c_str(), name.size());
+    if (directory == nullptr)
+    {
+        directory = &table.Lazy.Set(name, std::make_shared<rlas_LazyDirectory>());
+        CountPending(table, name, 1);
+    }
+
+    (*directory)->Sources.push_back(source);
+}
+
+void RemoveLazyDirectory(rlas_AssetTable& table, const std::string& name)
+{
+    size_t index = 0;
+    if (table.Lazy.Remove(name, index))
+        CountPending(table, name, -1);
+}
+
+// lists a single directory, its files are added and its sub directories and archives are left until something reaches them
+void AddDirectoryLazy(rlas_AssetTable& table, const std::string& root, const std::string& relPath, uint32_t mount)
+{
+    rlas_IndexedDirectory directory;
+    directory.Path = root;
+    directory.RelPath = relPath;
+    directory.Mount = mount;
+
+    // stamp before listing, so a change made during the listing makes the stamp out of date
+    rlas_GetFileStamp(root.c_str(), &directory.Stamp);
+
+    std::vector<rlas_DirectoryEntry> entries;
+    rlas_ListDirectory(root.c_str(), entries, true);
+    IndexedDirectories.push_back(directory);
+
+    std::sort(entries.begin(), entries.end(), [](const rlas_DirectoryEntry& a, const rlas_DirectoryEntry& b) { return a.Name < b.Name; });
+
+    for (auto& entry : entries)
+    {
+        rlas_LazySource source;
+        source.Mount = mount;
+
+        if (entry.IsDirectory)
+        {
+            source.Path = root + entry.Name + PathDelim;
+            source.RelPath = relPath + entry.Name + "/";
+            AddLazySource(table, source);
+        }
+        else if (IsArchiveFile(entry.Name))
+        {
+            source.Path = root + entry.Name;
+            source.RelPath = ArchiveRelPath(relPath + entry.Name);
+            source.IsArchive = true;
+            AddLazySource(table, source);
+        }
+        else
+        {
+            AddLooseFile(table, relPath + entry.Name, root + entry.Name, entry.Stamp, mount);
+        }
+    }
+}
+
+// true if a directory is the given one or is inside it, the root directory "" holds everything
+bool IsInDirectory(const std::string& name, const std::string& directory)
+{
+    if (directory.empty())
+        return true;
+
+    return name.size() >= directory.size() && rlas_PathEquals(name.c_str(), directory.size(), directory)
+        && (name.size() == directory.size() || name[directory.size()] == '/');
+}
+
+// only for a table that has not had a lazy directory read into a table of its own, like one from CopyAssetTable
+bool HasLazySources(const rlas_AssetTable& table, const std::string& directory, bool recursive)
+{
+    if (!recursive)
+        return table.Lazy.Find(directory.c_str(), directory.size()) != nullptr;
+
+    const uint32_t* count = table.Pending.Find(directory.c_str(), directory.size());
+    return count != nullptr && *count != 0;
+}
+
+// true if a directory, one on the way to it or with recursive one below it is still lazy, with the same limit as HasLazySources
+bool HasLazyParents(const rlas_AssetTable& table, const std::string& directory, bool recursive)
+{
+    for (size_t slash = directory.find('/'); slash != std::string::npos; slash = directory.find('/', slash + 1))
+    {
+        if (table.Lazy.Find(directory.c_str(), slash) != nullptr)
+            return true;
+    }
+    return HasLazySources(table, directory, recursive);
+}
+
+void ReadLazySources(rlas_AssetTable& table, const std::vector<rlas_LazySource>& sources)
+{
+    for (auto& source : sources)
+    {
+        if (!source.IsArchive)
+        {
+            AddDirectoryLazy(table, source.Path, source.RelPath, source.Mount);
+            continue;
+        }
+
+        // there is no caller to report a broken archive to, so it is left out like a missing file
+        try
+        {
+            AddArchiveFile(table, source.Path, source.RelPath, source.Mount);
+        }
+        catch (...)
+        {
+        }
+    }
+}
+
+// reads the lazy sources of a directory, and with recursive of everything below it, the caller must hold the mount lock
+// every resource path with the directory is read at once, and assets keep the mount that added them, so the override order is the same as an eager scan
+void IndexLazySources(rlas_AssetTable& table, const std::string& directory, bool recursive)
+{
+    while (HasLazySources(table, directory, recursive))
+    {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < table.Lazy.Size(); ++i)
+        {
+            const std::string& name = table.Lazy.NameAt(i);
+            if (recursive ? IsInDirectory(name, directory) : rlas_PathEquals(name.c_str(), name.size(), directory))
+                names.push_back(name);
+        }
+
+        for (auto& name : names)
+        {
+            std::vector<rlas_LazySource> sources = (*table.Lazy.Find(name.c_str()))->Sources;
+            RemoveLazyDirectory(table, name);
+            ReadLazySources(table, sources);
+        }
+
+        if (!recursive)
+            break;
+    }
+}
+
+// adds the lazy directories of a table to a new one, the assets and lazy directories of the ones that have been read instead of them
+// the assets already in the new table come first, so SetAsset keeps the same asset of a path an eager scan would
+void MergeLazyDirectories(rlas_AssetTable& table, const LazyMap& lazy)
+{
+    for (size_t i = 0; i < lazy.Size(); ++i)
+    {
+        const rlas_LazyDirectory& directory = *lazy.ItemAt(i);
+        if (!directory.Ready)
+        {
+            for (auto& source : directory.Sources)
+                AddLazySource(table, source);
+            continue;
+        }
+
+        const rlas_AssetTable& read = directory.Table;
+        for (size_t j = 0; j < read.Assets.Size(); ++j)
+            SetAsset(table, read.Assets.NameAt(j), read.Assets.ItemAt(j));
+
+        MergeLazyDirectories(table, read.Lazy);
+    }
+}
+
+// calls a function with the table of every lazy directory that has been read and not merged yet
+template<class F>
+void ForEachLazyTable(const LazyMap& lazy, F& function)
+{
+    for (size_t i = 0; i < lazy.Size(); ++i)
+    {
+        const rlas_LazyDirectory& directory = *lazy.ItemAt(i);
+        if (directory.Ready)
+        {
+            function(directory.Table);
+            ForEachLazyTable(directory.Table.Lazy, function);
+        }
+    }
+}
+
+void WatchIndexedDirectories();
+
+// reads a lazy directory into its own table and returns the layers lookups should continue with
+// the asset table is not copied, the layers are only published again so handles resolved before look their paths up again,
+// once the tables read hold as much as the asset table they are merged into a new one, so reading every directory costs about
+// as much as one eager scan and a lookup checks a few tables at most
+LayersPtr ReadLazyDirectory(const LayersPtr& layers, rlas_LazyDirectory& directory)
+{
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    // another thread may have read it, or replaced the table it is in, while this one waited for the lock
+    LayersPtr current = GetAssetLayers();
+    if (current->Table != layers->Table || directory.Ready)
+        return current;
+
+    ReadLazySources(directory.Table, directory.Sources);
+    directory.Ready.store(true, std::memory_order_release);
+
+    const rlas_AssetTable& table = *current->Table;
+    size_t lazyItems = current->LazyItems + directory.Table.Assets.Size() + directory.Table.Lazy.Size() + 1;
+    if (lazyItems < table.Assets.Size() + table.Lazy.Size())
+        current = PublishAssetLayers(current->Table, current->Mounts, lazyItems);
+    else
+        current = PublishAssetTable(CopyAssetTable());
+
+    WatchIndexedDirectories();
+    return current;
+}
+
+// reads every lazy directory on the way to a path before the path is looked up
+// a later resource path can override a file an earlier one has already indexed, so this can not wait for a lookup to miss
+LayersPtr IndexLazyParents(LayersPtr layers, const char* path)
+{
+    for (;;)
+    {
+        rlas_LazyDirectory* lazy = nullptr;
+        auto visit = [&lazy](rlas_LazyDirectory& directory)
+        {
+            if (directory.Ready.load(std::memory_order_acquire))
+                return true;
+
+            lazy = &directory;
+            return false;
+        };
+
+        VisitLazyParents(layers->Table->Lazy, path, path, visit);
+        if (lazy == nullptr)
+            return layers;
+
+        layers = ReadLazyDirectory(layers, *lazy);
+    }
+}
+
+// reads every lazy directory on the way to a directory and the directory itself, with recursive everything below it as well,
+// into a new table with nothing left in lazy directory tables, for listings and the rest that walk the asset map's tree
+LayersPtr IndexLazyTree(LayersPtr layers, const std::string& directory, bool recursive)
+{
+    if (layers->Table->Lazy.Size() == 0 || (layers->LazyItems == 0 && !HasLazyParents(*layers->Table, directory, recursive)))
+        return layers;
+
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    // another thread may have read it while this one waited for the lock
+    layers = GetAssetLayers();
+    if (layers->LazyItems == 0 && !HasLazyParents(*layers->Table, directory, recursive))
+        return layers;
+
+    std::shared_ptr<rlas_AssetTable> table = CopyAssetTable();
+    std::string path = directory + "/";
+    for (size_t slash = path.find('/'); slash != std::string::npos; slash = path.find('/', slash + 1))
+        IndexLazySources(*table, path.substr(0, slash), false);
+
+    if (recursive)
+        IndexLazySources(*table, directory, true);
+
+    layers = PublishAssetTable(table);
+    WatchIndexedDirectories();
+
+    return layers;
+}
+
+void AddResourcePath(rlas_AssetTable& table, const std::string& root)
+{
+    AssetRootPaths.emplace_back(root);
+
+    if (LazyIndexing)
+        AddDirectoryLazy(table, root, "", ++MountCount);
+    else
+        RecurseAddFiles(table, root, "", ++MountCount);
+}
+
+void rlas_AddAssetResourcePath(const char* path)
+{
+    if (path == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    std::shared_ptr<rlas_AssetTable> table = CopyAssetTable();
+    AddResourcePath(*table, path);
+    PublishAssetTable(table);
+    WatchIndexedDirectories();
+}
+
+void rlas_SetArchiveMemoryMapping(bool enabled)
+{
+    MapArchives = enabled;
+}
+
+void rlas_SetLazyIndexing(bool enabled)
+{
+    LazyIndexing = enabled;
+}
+
+void rlas_AddAssetResourceArchive(const char* path, bool relativeToApp)
+{
+    std::string pathToUse = path;
+
+    if (relativeToApp)
+    {
+        pathToUse = rlas_GetApplicationBasePath();
+        if (path != nullptr)
+        {
+            pathToUse += path;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    std::shared_ptr<rlas_AssetTable> table = CopyAssetTable();
+    AddArchiveFile(*table, pathToUse, "", ++MountCount);
+    PublishAssetTable(table);
+}
+
+char* LoadAssetText(const rlas_AssetMeta& meta, unsigned int* bytesRead);
+
+static const char* TombstoneFileName = "rlas_tombstones.txt";
+
+// reads the tombstone list of a mount and takes it out of the mount's files
+// each line is a path relative to the mount source, a line ending in '/' hides a whole directory and '#' starts a comment
+void ReadTombstones(rlas_MountPoint& mount)
+{
+    std::string listName = mount.Prefix + TombstoneFileName;
+    const AssetPtr* list = mount.Table.Assets.Find(listName.c_str());
+    if (list == nullptr)
+        return;
+
+    unsigned int size = 0;
+    char* text = LoadAssetText(**list, &size);
+    if (text != nullptr)
+    {
+        std::string line;
+        for (unsigned int i = 0; i <= size; ++i)
+        {
+            if (i < size && text[i] != '\n')
+            {
+                line += text[i] == '\\' ? '/' : text[i];
+                continue;
+            }
+
+            line.erase(std::min(line.find('#'), line.size()));
+            line.erase(line.find_last_not_of(" \t\r/") + 1);
+            line.erase(0, line.find_first_not_of(" \t/"));
+            if (!line.empty())
+                mount.Removed.Set(mount.Prefix + line, 1);
+            line.clear();
+        }
+        MemFree(text);
+    }
+
+    RemoveAsset(mount.Table, listName);
+}
+
+// reads a mount the first time a lookup reaches it, a source that can not be read mounts nothing
+// mounts are not part of the asset map, so they are not saved in the manifest or watched
+// every other lookup that reaches the mount blocks in call_once until it is read, so nothing in here may wait on jobs queued
+// to AssetWorkers, which can be busy with loads for a long time. The directory scan reads its own queue and
+// only takes help from workers that happen to be free
+const rlas_AssetTable& LoadMount(rlas_MountPoint& mount)
+{
+    std::call_once(mount.Loaded, [&mount]()
+    {
+        try
+        {
+            if (IsArchiveFile(mount.Source))
+                AddArchiveFile(mount.Table, mount.Source, mount.Prefix, mount.Id, false);
+            else
+                RecurseAddFiles(mount.Table, mount.Source, mount.Prefix, mount.Id, false);
+
+            ReadTombstones(mount);
+        }
+        catch (...)
+        {
+            mount.Table = rlas_AssetTable();
+            mount.Removed.Clear();
+        }
+        mount.Ready = true;
+    });
+
+    return mount.Table;
+}
+
+rlas_MountId rlas_Mount(const char* source, const char* virtualPrefix, int priority)
+{
+    if (source == nullptr || *source == '\0')
+        return 0;
+
+    MountPtr mount = std::make_shared<rlas_MountPoint>();
+    mount->Priority = priority;
+    mount->Source = source;
+    if (!IsArchiveFile(mount->Source) && mount->Source.back() != '/' && mount->Source.back() != PathDelim)
+        mount->Source += PathDelim;
+
+    std::string prefix = virtualPrefix == nullptr ? std::string() : virtualPrefix;
+    std::replace(prefix.begin(), prefix.end(), '\\', '/');
+    prefix.erase(0, prefix.find_first_not_of('/'));
+    if (!prefix.empty() && prefix.back() != '/')
+        prefix += '/';
+    mount->Prefix = prefix;
+
+    SetLoadFileDataCallback(LoadBinFile);
+    SetLoadFileTextCallback(LoadTextFile);
+
+    std::lock_guard<std::mutex> lock(MountLock);
+    mount->Id = ++MountCount;
+
+    // ahead of every mount with the same or a lower priority
+    LayersPtr layers = GetAssetLayers();
+    std::vector<MountPtr> mounts = layers->Mounts;
+    mounts.insert(std::find_if(mounts.begin(), mounts.end(), [priority](const MountPtr& other) { return other->Priority <= priority; }), mount);
+    PublishAssetLayers(layers->Table, mounts, layers->LazyItems);
+
+    return mount->Id;
+}
+
+// the mount's table is freed when the last lookup still using the old layers lets go of it
+bool rlas_Unmount(rlas_MountId id)
+{
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    LayersPtr layers = GetAssetLayers();
+    std::vector<MountPtr> mounts = layers->Mounts;
+    auto existing = std::find_if(mounts.begin(), mounts.end(), [id](const MountPtr& mount) { return mount->Id == id; });
+    if (existing == mounts.end())
+        return false;
+
+    mounts.erase(existing);
+    PublishAssetLayers(layers->Table, mounts, layers->LazyItems);
+    return true;
+}
+
+// true if a mount can have files in a directory, listing a directory above the prefix only reaches it when recursive
+bool MountReaches(const rlas_MountPoint& mount, const std::string& directory, bool recursive)
+{
+    std::string prefix = mount.Prefix.empty() ? std::string() : mount.Prefix.substr(0, mount.Prefix.size() - 1);
+    return IsInDirectory(directory, prefix) || (recursive && IsInDirectory(prefix, directory));
+}
+
+// calls a function for every asset in a directory that is not overridden or hidden, from the asset map and every mount that reaches it
+// the function returns false to stop
+template<class F>
+void VisitAssets(const rlas_AssetLayers& layers, const std::string& directory, bool recursive, F function)
+{
+    auto visit = [&](const rlas_AssetTable& index)
+    {
+        const rlas_DirectoryTree::Node* node = index.Tree.Find(directory.c_str());
+        if (node == nullptr)
+            return true;
+
+        return index.Tree.Visit(*node, recursive, [&](uint32_t item)
+            {
+                const AssetPtr& meta = index.Assets.ItemAt(item);
+                return FindInTable(layers, meta->RelativeName.c_str()) != &meta || function(meta);
+            });
+    };
+
+    if (!visit(*layers.Table))
+        return;
+
+    for (auto& mount : layers.Mounts)
+    {
+        if (MountReaches(*mount, directory, recursive) && !visit(LoadMount(*mount)))
+            return;
+    }
+}
+
+// calls a function with the asset map, the lazy directory tables and every mount that has been read, overridden assets included
+template<class F>
+void ForEachIndex(const rlas_AssetLayers& layers, F function)
+{
+    function(*layers.Table);
+    ForEachLazyTable(layers.Table->Lazy, function);
+    for (auto& mount : layers.Mounts)
+    {
+        if (mount->Ready)
+            function(mount->Table);
+    }
+}
+
+bool GetAssetView(const rlas_AssetMeta& meta, rlas_AssetView* view);
+
+bool WriteTempFile(const std::string& path, const rlas_AssetView& view)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    bool written = fwrite(view.data, 1, view.size, file) == view.size;
+    written = fclose(file) == 0 && written;
+    if (!written)
+        remove(path.c_str());
+
+    return written;
+}
+
+// writes a file under a unique name next to its path and then moves it into place,
+// so other processes sharing the directory never see a partial file or write over each other
+template<class Write>
+bool ReplaceFileWith(const std::string& path, Write write)
+{
+    std::string partial;
+    FILE* file = rlas_CreateUniqueFile(path.c_str(), partial);
+    if (file == nullptr)
+        return false;
+
+    bool written = write(file);
+    written = fclose(file) == 0 && written;
+    written = written && rlas_ReplaceFile(partial.c_str(), path.c_str());
+    if (!written)
+        remove(partial.c_str());
+
+    return written;
+}
+
+const char* rlas_GetAssetPath(const char* path)
+{
+    AssetPtr meta = FindAsset(path);
+    if (meta == nullptr)
+        return nullptr;
+
+    if (meta->ArchiveFile == nullptr)
+        return meta->PathOnDisk.c_str();
+
+    std::lock_guard<std::mutex> lock(TempLock);
+
+    // the same entry of the same version of an archive is only extracted once
+    // pack entries have no zip header, the entry index tells them apart
+    uint64_t entry = meta->ArchiveFile->IsPack ? meta->PackEntry : meta->ArchiveInfo.header_offset;
+    std::string key = meta->PathOnDisk + "|" + std::to_string(meta->ArchiveFile->Stamp.ModTime) + "|" + std::to_string(entry);
+    TempMap::iterator existing = TempFiles.find(key);
+    if (existing != TempFiles.end())
+        return existing->second.Path.c_str();
+
+    if (AssetTempPath.empty() && ExtractionMode != RLAS_EXTRACT_MEMORY_FILES)  // no place to extract, return null
+        return nullptr;
+
+    std::string tempName = meta->RelativeName;
+    std::replace(tempName.begin(), tempName.end(), '/', '_');
+
+    // the same virtual path can come from more than one archive or from two versions of one, so the name also holds
+    // the archive and the crc and size of the entry, a cached file left by an earlier run can then be used as is
+    char prefix[48];
+    snprintf(prefix, sizeof(prefix), "%016llx_%08x_%llu_", (unsigned long long)rlas_HashPath(meta->ArchiveFile->Path.c_str()),
+        (unsigned int)meta->ArchiveInfo.crc, (unsigned long long)meta->ArchiveInfo.file_size);
+
+    rlas_TempFile temp;
+    if (ExtractionMode == RLAS_EXTRACT_CACHED_FILES)
+    {
+        temp.Path = AssetTempPath + prefix + tempName;
+        temp.Keep = true;
+
+        rlas_FileStamp stamp;
+        if (rlas_GetFileStamp(temp.Path.c_str(), &stamp) && (uint64_t)stamp.Size == meta->ArchiveInfo.file_size)
+            return TempFiles.insert(std::make_pair(key, temp)).first->second.Path.c_str();
+    }
+    else if (ExtractionMode == RLAS_EXTRACT_TEMP_FILES)
+    {
+        temp.Path = AssetTempPath + prefix + tempName;
+    }
+
+    // stored entries are written straight from the archive without a copy
+    rlas_AssetView view;
+    if (!GetAssetView(*meta, &view))
+        return nullptr;
+
+    bool written = false;
+    if (ExtractionMode == RLAS_EXTRACT_MEMORY_FILES)
+    {
+        temp.MemoryFile = rlas_CreateMemoryFile(tempName.c_str(), view.data, view.size, temp.Path);
+        written = temp.MemoryFile >= 0;
+    }
+    else if (ExtractionMode == RLAS_EXTRACT_CACHED_FILES)
+    {
+        written = ReplaceFileWith(temp.Path, [&view](FILE* file) { return fwrite(view.data, 1, view.size, file) == view.size; });
+    }
+    else
+    {
+        written = WriteTempFile(temp.Path, view);
+    }
+
+    if (written)
+    {
+        rlas_AddStat(Stats.TempExtractions);
+        rlas_AddStat(Stats.TempExtractionBytes, view.size);
+    }
+
+    rlas_ReleaseAssetView(&view);
+
+    if (!written)
+        return nullptr;
+
+    return TempFiles.insert(std::make_pair(key, temp)).first->second.Path.c_str();
+}
+
+int rlas_AppendPath(const char* path, const char* subpath, char* destination, int lenght)
+{
+    std::string p = path;
+    std::string sp = subpath;
+    std::string result = p + PathDelim + sp;
+
+    if (result.size() > lenght - 1)
+        return -1;
+
+#ifdef _WIN32
+    strncpy_s(destination, lenght, result.c_str(), result.size());
+#else
+    strncpy(destination, result.c_str(), result.size());
+#endif //_WIN32
+    destination[result.size()] = '\0';
+
+    return static_cast<int>(result.size());
+}
+
+int rlas_GetAssetsInPath(const char* path, bool recursive, char* results[])
+{
+    return rlas_ListAssetsInPath(path, recursive, (const char**)results, results == nullptr ? 0 : INT_MAX);
+}
+
+int rlas_ListAssetsInPath(const char* path, bool includeSubDirectories, const char** results, int maxResults)
+{
+    LayersPtr layers = GetAssetLayers();
+    if (layers->Table->Lazy.Size() != 0 || !layers->Mounts.empty())
+    {
+        std::string directory = path == nullptr ? std::string() : path;
+        directory.erase(0, directory.find_first_not_of('/'));
+        directory.erase(directory.find_last_not_of('/') + 1);
+
+        layers = IndexLazyTree(layers, directory, includeSubDirectories);
+
+        // with a mount in the directory every asset has to be checked for overrides and tombstones, so the total is counted
+        bool mounted = false;
+        for (auto& mount : layers->Mounts)
+            mounted = mounted || MountReaches(*mount, directory, includeSubDirectories);
+
+        if (mounted)
+        {
+            int total = 0;
+            VisitAssets(*layers, directory, includeSubDirectories, [&](const AssetPtr& meta)
+                {
+                    if (results != nullptr && total < maxResults)
+                        results[total] = meta->RelativeName.c_str();
+                    ++total;
+                    return true;
+                });
+            return total;
+        }
+    }
+
+    const TablePtr& table = layers->Table;
+    const rlas_DirectoryTree::Node* node = table->Tree.Find(path);
+    if (node == nullptr)
+        return 0;
+
+    int total = includeSubDirectories ? (int)node->TotalFiles : (int)node->Files.size();
+    if (results == nullptr || maxResults <= 0)
+        return total;
+
+    int count = 0;
+    table->Tree.Visit(*node, includeSubDirectories, [&](uint32_t item)
+        {
+            results[count++] = table->Assets.ItemAt(item)->RelativeName.c_str();
+            return count < maxResults;
+        });
+
+    return total;
+}
+
+bool rlas_FileIsArchive(const char* path)
+{
+    AssetPtr meta = FindAsset(path);
+    if (meta == nullptr)
+        return false;
+
+    return meta->ArchiveFile != nullptr;
+}
+
+FILE* OpenAssetFile(const char* fileName, const char* mode)
+{
+    rlas_StatTimer timer(Stats.FileOpenNanoseconds, &Stats.FileOpens);
+    return fopen(fileName, mode);
+}
+
+int OpenReadFile(const char* fileName, uint64_t* size)
+{
+    rlas_StatTimer timer(Stats.FileOpenNanoseconds, &Stats.FileOpens);
+    return rlas_OpenReadFile(fileName, size);
+}
+
+// reads a whole file with one open, one fstat and one read into a buffer from allocate(size)
+// returns false if the file can not be opened, allocate returns nullptr or the read is short, the caller frees the buffer in any case
+template<class Allocate>
+bool ReadLooseFile(const char* fileName, uint64_t& size, unsigned char*& buffer, Allocate allocate)
+{
+    buffer = nullptr;
+    int file = OpenReadFile(fileName, &size);
+    if (file < 0)
+        return false;
+
+    bool read = false;
+    if (size < UINT_MAX)
+    {
+        buffer = allocate(size);
+        read = buffer != nullptr && rlas_ReadFileAt(file, 0, buffer, (size_t)size) == size;
+    }
+
+    rlas_CloseReadFile(file);
+    return read;
+}
+
+// reads a whole zip entry into a buffer of at least file_size bytes
+bool ReadZipEntry(miniz_cpp::zip_file& archive, const rlas_AssetMeta& meta, void* buffer)
+{
+    if (meta.ArchiveInfo.compress_type == 0)
+        return archive.readBin(meta.ArchiveInfo, buffer) == meta.ArchiveInfo.file_size;
+
+    rlas_StatTimer timer(Stats.InflateNanoseconds, &Stats.Inflates);
+    rlas_AddStat(Stats.InflatedBytes, meta.ArchiveInfo.file_size);
+    return archive.readBin(meta.ArchiveInfo, buffer) == meta.ArchiveInfo.file_size;
+}
+
+size_t ReadPackEntry(const rlas_PackFile& pack, const rlas_AssetMeta& meta, uint64_t offset, void* buffer, size_t size)
+{
+    rlas_StatTimer timer(Stats.InflateNanoseconds, &Stats.Inflates);
+    size_t read = pack.Read(meta.PackEntry, offset, buffer, size);
+    rlas_AddStat(Stats.InflatedBytes, read);
+    return read;
+}
+
+// adds data read through the public API to the counters of the asset and the totals
+void RecordRead(const rlas_AssetMeta& meta, uint64_t bytes, uint64_t start)
+{
+    if (!rlas_StatsOn())
+        return;
+
+    rlas_AddStat(meta.ArchiveFile == nullptr ? Stats.DiskBytes : Stats.ArchiveBytes, bytes);
+    rlas_AddStat(meta.Counters.Bytes, bytes);
+    rlas_AddStat(meta.Counters.LoadNanoseconds, rlas_StatClock() - start);
+}
+
+void RecordLoad(const rlas_AssetMeta& meta, uint64_t bytes, uint64_t start)
+{
+    rlas_AddStat(Stats.Loads);
+    rlas_AddStat(meta.Counters.Loads);
+    RecordRead(meta, bytes, start);
+}
+
+// text read from a loose file gets the same line endings reading in text mode gives, returns the new size
+unsigned int FoldLineEndings(unsigned char* data, unsigned int size)
+{
+#if defined(_WIN32)
+    unsigned int length = 0;
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        if (data[i] != '\r' || i + 1 >= size || data[i + 1] != '\n')
+            data[length++] = data[i];
+    }
+    return length;
+#else
+    (void)data;
+    return size;
+#endif
+}
+
+void* ReadFileContents(const char* fileName, unsigned int* bytesRead, bool binary)
+{
+    *bytesRead = 0;
+    if (fileName == NULL)
+        return NULL;
+
+    // text gets room for a terminator
+    uint64_t size = 0;
+    unsigned char* data = nullptr;
+    bool read = ReadLooseFile(fileName, size, data, [binary](uint64_t size)
+    {
+        return size > 0 ? (unsigned char*)MemAlloc((unsigned int)size + (binary ? 0 : 1)) : nullptr;
+    });
+
+    if (!read)
+    {
+        if (data != nullptr)
+            MemFree(data);
+        return NULL;
+    }
+
+    *bytesRead = (unsigned int)size;
+    if (!binary)
+    {
+        *bytesRead = FoldLineEndings(data, *bytesRead);
+        data[*bytesRead] = '\0';
+    }
+
+    return data;
+}
+
+rlas_DataCache::Data GetCachedArchiveData(const rlas_AssetMeta& meta)
+{
+    // stored entries are cheap to copy out of the archive, only inflated data is worth keeping
+    // packs are left out, their blocks are small enough to inflate again
+    if (meta.ArchiveFile == nullptr || meta.ArchiveFile->IsPack || meta.ArchiveInfo.compress_type == 0 || !ArchiveCache.Enabled())
+        return nullptr;
+
+    rlas_DataCache::Data data = ArchiveCache.Find(meta.ArchiveFile, meta.ArchiveInfo.header_offset);
+    if (data != nullptr)
+        return data;
+
+    std::shared_ptr<miniz_cpp::zip_file> archive = meta.ArchiveFile->Open();
+    if (archive == nullptr)
+        return nullptr;
+
+    std::shared_ptr<std::vector<unsigned char>> bytes = std::make_shared<std::vector<unsigned char>>(meta.ArchiveInfo.file_size);
+    if (!ReadZipEntry(*archive, meta, bytes->data()))
+        return nullptr;
+
+    ArchiveCache.Add(meta.ArchiveFile, meta.ArchiveInfo.header_offset, bytes);
+    return bytes;
+}
+
+// reads a whole pack entry into a new buffer with extra bytes after the data
+unsigned char* LoadPackEntry(const rlas_AssetMeta& meta, unsigned int padding)
+{
+    std::shared_ptr<rlas_PackFile> pack = meta.ArchiveFile->OpenPack();
+    if (pack == nullptr)
+        return nullptr;
+
+    size_t size = meta.ArchiveInfo.file_size;
+    unsigned char* buffer = (unsigned char*)MemAlloc((unsigned int)(size + padding));
+    if (ReadPackEntry(*pack, meta, 0, buffer, size) != size)
+    {
+        MemFree(buffer);
+        return nullptr;
+    }
+
+    return buffer;
+}
+
+unsigned char* LoadAssetData(const rlas_AssetMeta& meta, unsigned int* bytesRead)
+{
+    if (meta.ArchiveFile != nullptr && meta.ArchiveFile->IsPack)
+    {
+        unsigned char* buffer = LoadPackEntry(meta, 0);
+        *bytesRead = buffer != nullptr ? (unsigned int)meta.ArchiveInfo.file_size : 0;
+        return buffer;
+    }
+
+    rlas_DataCache::Data cached = GetCachedArchiveData(meta);
+    if (cached != nullptr)
+    {
+        *bytesRead = (unsigned int)cached->size();
+        unsigned char* buffer = (unsigned char*)MemAlloc((unsigned int)cached->size());
+        memcpy(buffer, cached->data(), cached->size());
+
+        return buffer;
+    }
+
+    if (meta.ArchiveFile != nullptr)
+    {
+        *bytesRead = 0;
+        std::shared_ptr<miniz_cpp::zip_file> archive = meta.ArchiveFile->Open();
+        if (archive == nullptr)
+            return nullptr;
+
+        unsigned char* buffer = (unsigned char*)MemAlloc((unsigned int)meta.ArchiveInfo.file_size);
+        if (!ReadZipEntry(*archive, meta, buffer))
+        {
+            MemFree(buffer);
+            return nullptr;
+        }
+        *bytesRead = (unsigned int)meta.ArchiveInfo.file_size;
+
+        return buffer;
+    }
+
+    return (unsigned char*)ReadFileContents(meta.PathOnDisk.c_str(), bytesRead, true);
+}
+
+char* LoadAssetText(const rlas_AssetMeta& meta, unsigned int* bytesRead)
+{
+    *bytesRead = 0;
+
+    if (meta.ArchiveFile != nullptr && meta.ArchiveFile->IsPack)
+    {
+        char* buffer = (char*)LoadPackEntry(meta, 1);
+        if (buffer != nullptr)
+        {
+            buffer[meta.ArchiveInfo.file_size] = '\0';
+            *bytesRead = (unsigned int)meta.ArchiveInfo.file_size;
+        }
+        return buffer;
+    }
+
+    rlas_DataCache::Data cached = GetCachedArchiveData(meta);
+    if (cached != nullptr)
+    {
+        char* buffer = (char*)MemAlloc((unsigned int)cached->size() + 1);
+        memcpy(buffer, cached->data(), cached->size());
+        buffer[cached->size()] = '\0';
+        *bytesRead = (unsigned int)cached->size();
+
+        return buffer;
+    }
+
+    if (meta.ArchiveFile != nullptr)
+    {
+        std::shared_ptr<miniz_cpp::zip_file> archive = meta.ArchiveFile->Open();
+        if (archive == nullptr)
+            return nullptr;
+
+        char* buffer = (char*)MemAlloc((unsigned int)meta.ArchiveInfo.file_size + 1);
+        if (!ReadZipEntry(*archive, meta, buffer))
+        {
+            MemFree(buffer);
+            return nullptr;
+        }
+        buffer[meta.ArchiveInfo.file_size] = '\0';
+        *bytesRead = (unsigned int)meta.ArchiveInfo.file_size;
+
+        return buffer;
+    }
+
+    return (char*)ReadFileContents(meta.PathOnDisk.c_str(), bytesRead, false);
+}
+
+unsigned char* LoadBinFile(const char* fileName, unsigned int* bytesRead)
+{
+    AssetPtr meta = FindAsset(fileName);
+    if (meta == nullptr)
+    {
+        *bytesRead = 0;
+        if (FileExists(fileName))
+        {
+            return (unsigned char*)ReadFileContents(fileName, bytesRead, true);
+        }
+        return nullptr;
+    }
+
+    uint64_t start = rlas_StatClock();
+    unsigned char* data = LoadAssetData(*meta, bytesRead);
+    RecordLoad(*meta, *bytesRead, start);
+    return data;
+}
+
+char* LoadTextFile(const char* fileName)
+{
+    AssetPtr meta = FindAsset(fileName);
+    if (meta == nullptr)
+    {
+        if (FileExists(fileName))
+        {
+            unsigned int bytesRead = 0;
+            return (char*)ReadFileContents(fileName, &bytesRead, false);
+        }
+        return nullptr;
+    }
+
+    uint64_t start = rlas_StatClock();
+    unsigned int bytesRead = 0;
+    char* text = LoadAssetText(*meta, &bytesRead);
+    RecordLoad(*meta, bytesRead, start);
+    return text;
+}
+
+bool GetAssetSize(const rlas_AssetMeta& meta, uint64_t& size)
+{
+    if (meta.ArchiveFile != nullptr)
+    {
+        size = meta.ArchiveInfo.file_size;
+        return true;
+    }
+
+    // files are stamped when they are scanned, files from a manifest or added some other way need a stat
+    if (meta.Stamp.ModTime != 0)
+    {
+        size = (uint64_t)meta.Stamp.Size;
+        return true;
+    }
+
+    rlas_FileStamp stamp;
+    if (!rlas_GetFileStamp(meta.PathOnDisk.c_str(), &stamp))
+        return false;
+
+    size = (uint64_t)stamp.Size;
+    return true;
+}
+
+unsigned int rlas_GetFileSize(const char* path)
+{
+    AssetPtr meta = FindAsset(path);
+    uint64_t size = 0;
+    if (meta == nullptr || !GetAssetSize(*meta, size))
+        return 0;
+
+    return (unsigned int)size;
+}
+
+rlas_AssetHandle rlas_ResolveHandle(const char* path)
+{
+    if (path == nullptr || *path == '\0')
+        return 0;
+
+    std::lock_guard<std::mutex> lock(HandleLock);
+
+    const uint32_t* existing = HandleNames.Find(path);
+    if (existing != nullptr)
+        return *existing;
+
+    uint32_t index = HandleCount.load(std::memory_order_relaxed);
+    uint32_t chunk = index >> HandleChunkShift;
+    if (chunk >= HandleChunkCount)
+        return 0;
+
+    if (HandleChunks[chunk] == nullptr)
+    {
+        HandleChunks[chunk].reset(new rlas_HandleSlot[HandleChunkSize]);
+        for (uint32_t i = 0; i < HandleChunkSize; ++i)
+            HandleChunks[chunk][i].Resolved = 0;
+        HandleSlots[chunk].store(HandleChunks[chunk].get(), std::memory_order_release);
+    }
+
+    HandleChunks[chunk][index & (HandleChunkSize - 1)].Path = path;
+    HandleNames.Set(path, index + 1);
+    HandleCount.store(index + 1, std::memory_order_release);
+
+    return index + 1;
+}
+
+const char* rlas_GetHandlePath(rlas_AssetHandle handle)
+{
+    rlas_HandleSlot* slot = GetHandleSlot(handle);
+    return slot == nullptr ? nullptr : slot->Path.c_str();
+}
+
+unsigned int rlas_GetFileSizeByHandle(rlas_AssetHandle handle)
+{
+    AssetPtr meta = FindAsset(handle);
+    uint64_t size = 0;
+    if (meta == nullptr || !GetAssetSize(*meta, size))
+        return 0;
+
+    return (unsigned int)size;
+}
+
+bool rlas_FileIsArchiveByHandle(rlas_AssetHandle handle)
+{
+    AssetPtr meta = FindAsset(handle);
+    return meta != nullptr && meta->ArchiveFile != nullptr;
+}
+
+unsigned char* rlas_LoadAssetByHandle(rlas_AssetHandle handle, unsigned int* bytesRead)
+{
+    *bytesRead = 0;
+
+    AssetPtr meta = FindAsset(handle);
+    if (meta == nullptr)
+        return nullptr;
+
+    uint64_t start = rlas_StatClock();
+    unsigned char* data = LoadAssetData(*meta, bytesRead);
+    RecordLoad(*meta, *bytesRead, start);
+    return data;
+}
+
+char* rlas_LoadAssetTextByHandle(rlas_AssetHandle handle)
+{
+    AssetPtr meta = FindAsset(handle);
+    if (meta == nullptr)
+        return nullptr;
+
+    uint64_t start = rlas_StatClock();
+    unsigned int bytesRead = 0;
+    char* text = LoadAssetText(*meta, &bytesRead);
+    RecordLoad(*meta, bytesRead, start);
+    return text;
+}
+
+size_t ReadAssetRange(const rlas_AssetMeta& meta, uint64_t offset, void* buffer, size_t size)
+{
+    if (meta.ArchiveFile == nullptr)
+    {
+        uint64_t fileSize = 0;
+        int file = OpenReadFile(meta.PathOnDisk.c_str(), &fileSize);
+        if (file < 0)
+            return 0;
+
+        size_t read = rlas_ReadFileAt(file, offset, buffer, size);
+        rlas_CloseReadFile(file);
+        return read;
+    }
+
+    if (offset >= meta.ArchiveInfo.file_size)
+        return 0;
+    size = (size_t)std::min<uint64_t>(size, meta.ArchiveInfo.file_size - offset);
+
+    if (meta.ArchiveFile->IsPack)
+    {
+        std::shared_ptr<rlas_PackFile> pack = meta.ArchiveFile->OpenPack();
+        return pack != nullptr ? ReadPackEntry(*pack, meta, offset, buffer, size) : 0;
+    }
+
+    std::shared_ptr<miniz_cpp::zip_file> archive = meta.ArchiveFile->Open();
+    if (archive == nullptr)
+        return 0;
+
+    const unsigned char* stored = (const unsigned char*)archive->stored_data(meta.ArchiveInfo);
+    if (stored != nullptr)
+    {
+        memcpy(buffer, stored + offset, size);
+        return size;
+    }
+
+    // a deflated zip entry can only be inflated from the start
+    rlas_DataCache::Data cached = GetCachedArchiveData(meta);
+    if (cached != nullptr)
+    {
+        memcpy(buffer, cached->data() + offset, size);
+        return size;
+    }
+
+    // a whole entry is inflated straight into the destination
+    if (offset == 0 && size == meta.ArchiveInfo.file_size)
+        return ReadZipEntry(*archive, meta, buffer) ? size : 0;
+
+    std::vector<unsigned char> data(meta.ArchiveInfo.file_size);
+    if (!ReadZipEntry(*archive, meta, data.data()))
+        return 0;
+
+    memcpy(buffer, data.data() + offset, size);
+    return size;
+}
+
+// loads a whole asset into a buffer from allocate(size), reading or inflating straight into it
+// the caller frees the buffer even when the load fails
+template<class Allocate>
+bool LoadAssetWith(const rlas_AssetMeta& meta, uint64_t& size, unsigned char*& buffer, Allocate allocate)
+{
+    // the size of a file is taken when it is opened, so a file that changed since it was indexed is still read whole
+    if (meta.ArchiveFile == nullptr)
+        return ReadLooseFile(meta.PathOnDisk.c_str(), size, buffer, allocate);
+
+    size = meta.ArchiveInfo.file_size;
+    buffer = allocate(size);
+    return buffer != nullptr && ReadAssetRange(meta, 0, buffer, (size_t)size) == size;
+}
+
+unsigned int LoadAssetIntoBuffer(const char* path, void* buffer, unsigned int bufferSize, bool text)
+{
+    AssetPtr meta = FindAsset(path);
+    if (meta == nullptr || buffer == nullptr)
+        return 0;
+
+    uint64_t start = rlas_StatClock();
+    uint64_t size = 0;
+    unsigned char* data = nullptr;
+    bool loaded = LoadAssetWith(*meta, size, data, [buffer, bufferSize, text](uint64_t size)
+    {
+        return size + (text ? 1 : 0) <= bufferSize ? static_cast<unsigned char*>(buffer) : nullptr;
+    });
+    RecordLoad(*meta, loaded ? size : 0, start);
+
+    if (!loaded)
+        return 0;
+
+    // the same text LoadAssetText gives for the asset
+    if (text)
+    {
+        if (meta->ArchiveFile == nullptr)
+            size = FoldLineEndings(data, (unsigned int)size);
+        data[size] = '\0';
+    }
+    return (unsigned int)size;
+}
+
+unsigned int rlas_LoadAssetInto(const char* path, void* buffer, unsigned int bufferSize)
+{
+    return LoadAssetIntoBuffer(path, buffer, bufferSize, false);
+}
+
+unsigned int rlas_LoadAssetTextInto(const char* path, char* buffer, unsigned int bufferSize)
+{
+    return LoadAssetIntoBuffer(path, buffer, bufferSize, true);
+}
+
+unsigned char* rlas_LoadTransient(const char* path, unsigned int* bytesRead)
+{
+    if (bytesRead != nullptr)
+        *bytesRead = 0;
+
+    AssetPtr meta = FindAsset(path);
+    if (meta == nullptr)
+        return nullptr;
+
+    uint64_t start = rlas_StatClock();
+    uint64_t size = 0;
+    unsigned char* buffer = nullptr;
+    bool loaded = LoadAssetWith(*meta, size, buffer, [](uint64_t size)
+    {
+        return size < UINT_MAX ? TransientBuffers.Acquire((size_t)size + 1) : nullptr;
+    });
+    RecordLoad(*meta, loaded ? size : 0, start);
+
+    if (!loaded)
+    {
+        TransientBuffers.Release(buffer);
+        return nullptr;
+    }
+
+    buffer[size] = '\0';
+    if (bytesRead != nullptr)
+        *bytesRead = (unsigned int)size;
+    return buffer;
+}
+
+void rlas_ReleaseTransient(unsigned char* data)
+{
+    TransientBuffers.Release(data);
+}
+
+void rlas_SetTransientPoolBudget(unsigned long long bytes)
+{
+    TransientBuffers.SetBudget(bytes);
+}
+
+unsigned int rlas_ReadAssetRange(const char* path, unsigned long long offset, void* buffer, unsigned int size)
+{
+    AssetPtr meta = FindAsset(path);
+    if (meta == nullptr || buffer == nullptr)
+        return 0;
+
+    uint64_t start = rlas_StatClock();
+    size_t read = ReadAssetRange(*meta, offset, buffer, size);
+    RecordLoad(*meta, read, start);
+    return (unsigned int)read;
+}
+
+bool GetAssetView(const rlas_AssetMeta& meta, rlas_AssetView* view)
+{
+    view->data = nullptr;
+    view->size = 0;
+    view->mapped = false;
+    view->owner = nullptr;
+
+    std::shared_ptr<rlas_PackFile> pack = meta.ArchiveFile != nullptr ? meta.ArchiveFile->OpenPack() : nullptr;
+    const void* packed = pack != nullptr ? pack->StoredData(meta.PackEntry) : nullptr;
+    if (packed != nullptr)
+    {
+        view->data = (const unsigned char*)packed;
+        view->size = (unsigned int)meta.ArchiveInfo.file_size;
+        view->mapped = true;
+        view->owner = new std::shared_ptr<void>(pack);
+        return true;
+    }
+
+    std::shared_ptr<miniz_cpp::zip_file> archive = meta.ArchiveFile != nullptr ? meta.ArchiveFile->Open() : nullptr;
+    if (archive != nullptr)
+    {
+        const void* stored = archive->stored_data(meta.ArchiveInfo);
+        if (stored != nullptr)
+        {
+            // hold a reference to the archive so the data stays valid until the view is released
+            view->data = (const unsigned char*)stored;
+            view->size = (unsigned int)meta.ArchiveInfo.file_size;
+            view->mapped = true;
+            view->owner = new std::shared_ptr<void>(archive);
+            return true;
+        }
+    }
+
+    view->data = LoadAssetData(meta, &view->size);
+    return view->data != nullptr;
+}
+
+bool rlas_GetAssetView(const char* path, rlas_AssetView* view)
+{
+    if (view == nullptr)
+        return false;
+
+    AssetPtr meta = FindAsset(path);
+    if (meta == nullptr)
+    {
+        view->data = nullptr;
+        view->size = 0;
+        view->mapped = false;
+        view->owner = nullptr;
+        return false;
+    }
+
+    uint64_t start = rlas_StatClock();
+    bool loaded = GetAssetView(*meta, view);
+    RecordLoad(*meta, view->size, start);
+    return loaded;
+}
+
+void rlas_ReleaseAssetView(rlas_AssetView* view)
+{
+    if (view == nullptr)
+        return;
+
+    if (view->mapped)
+        delete (std::shared_ptr<void>*)view->owner;
+    else if (view->data != nullptr)
+        MemFree((void*)view->data);
+
+    view->data = nullptr;
+    view->size = 0;
+    view->mapped = false;
+    view->owner = nullptr;
+}
+
+// seeks beyond 2GB need the 64 bit file calls
+bool SeekFile(FILE* file, uint64_t position)
+{
+#ifdef _WIN32
+    return _fseeki64(file, (__int64)position, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)position, SEEK_SET) == 0;
+#endif //_WIN32
+}
+
+static const size_t StreamFileBufferSize = 64 * 1024;
+
+// A stream reads an asset in pieces with a fixed amount of memory
+// Loose files use a buffered file, stored archive entries are copied from the archive data,
+// deflated zip entries are inflated through a window as they are read and pack entries keep the last block they decompressed
+struct rlas_AssetStream
+{
+    AssetPtr Meta;
+    uint64_t Size = 0;
+    uint64_t Position = 0;
+
+    FILE* File = nullptr;
+
+    std::shared_ptr<void> Owner;            // keeps the archive open
+    const unsigned char* Data = nullptr;    // the entry as stored in the archive
+    size_t DataSize = 0;
+
+    bool Deflated = false;
+    tinfl_decompressor Inflator;
+    size_t InputOffset = 0;
+    std::vector<unsigned char> Window;      // the inflate dictionary, also holds inflated bytes that have not been read yet
+    size_t WindowOffset = 0;
+    size_t Pending = 0;                     // inflated bytes in the window ending at WindowOffset
+    uint64_t Inflated = 0;                  // total bytes inflated from the start of the entry
+    bool Failed = false;
+
+    std::shared_ptr<rlas_PackFile> Pack;
+    std::vector<unsigned char> Block;
+    uint64_t BlockStart = 0;
+    size_t BlockSize = 0;                   // bytes in Block, 0 when no block is loaded
+
+    std::vector<unsigned char> Copy;        // entries that can not be streamed (encrypted zip entries) are loaded whole
+
+    ~rlas_AssetStream()
+    {
+        if (File != nullptr)
+            fclose(File);
+    }
+};
+
+void RestartInflate(rlas_AssetStream& stream)
+{
+    tinfl_init(&stream.Inflator);
+    stream.InputOffset = 0;
+    stream.WindowOffset = 0;
+    stream.Pending = 0;
+    stream.Inflated = 0;
+    stream.Failed = false;
+}
+
+// inflates the next bytes of a deflated entry, passing them to the destination unless it is null (used to skip forward)
+size_t ReadInflated(rlas_AssetStream& stream, unsigned char* destination, size_t size)
+{
+    size_t done = 0;
+    while (done < size && !stream.Failed)
+    {
+        if (stream.Pending == 0)
+        {
+            if (stream.Inflated >= stream.Size)
+                break;
+
+            size_t inputSize = stream.DataSize - stream.InputOffset;
+            size_t outputSize = stream.Window.size() - stream.WindowOffset;
+            tinfl_status status = tinfl_decompress(&stream.Inflator, stream.Data + stream.InputOffset, &inputSize,
+                stream.Window.data(), stream.Window.data() + stream.WindowOffset, &outputSize, 0);
+
+            stream.InputOffset += inputSize;
+            stream.WindowOffset = (stream.WindowOffset + outputSize) & (stream.Window.size() - 1);
+            stream.Pending = outputSize;
+            stream.Inflated += outputSize;
+
+            if (status < TINFL_STATUS_DONE || (outputSize == 0 && status != TINFL_STATUS_HAS_MORE_OUTPUT))
+            {
+                stream.Failed = status < TINFL_STATUS_DONE || stream.Inflated < stream.Size;
+                if (outputSize == 0)
+                    break;
+            }
+        }
+
+        // the pending bytes end at the window offset, and never wrap because each inflate call stops at the end of the window
+        size_t start = (stream.WindowOffset == 0 ? stream.Window.size() : stream.WindowOffset) - stream.Pending;
+        size_t count = std::min(stream.Pending, size - done);
+        if (destination != nullptr)
+            memcpy(destination + done, stream.Window.data() + start, count);
+
+        stream.Pending -= count;
+        done += count;
+    }
+
+    return done;
+}
+
+size_t ReadPackStream(rlas_AssetStream& stream, unsigned char* destination, size_t size)
+{
+    uint32_t blockSize = stream.Pack->GetBlockSize();
+    size_t done = 0;
+
+    while (done < size)
+    {
+        uint64_t position = stream.Position + done;
+        if (stream.BlockSize == 0 || position < stream.BlockStart || position >= stream.BlockStart + stream.BlockSize)
+        {
+            uint64_t blockStart = position - position % blockSize;
+            size_t length = (size_t)std::min<uint64_t>(blockSize, stream.Size - blockStart);
+
+            // whole blocks go straight to the destination
+            if (position == blockStart && size - done >= length)
+            {
+                if (ReadPackEntry(*stream.Pack, *stream.Meta, blockStart, destination + done, length) != length)
+                    break;
+                done += length;
+                continue;
+            }
+
+            stream.Block.resize(blockSize);
+            stream.BlockSize = ReadPackEntry(*stream.Pack, *stream.Meta, blockStart, stream.Block.data(), length);
+            stream.BlockStart = blockStart;
+            if (stream.BlockSize != length)
+            {
+                stream.BlockSize = 0;
+                break;
+            }
+        }
+
+        size_t offset = (size_t)(position - stream.BlockStart);
+        size_t count = std::min(stream.BlockSize - offset, size - done);
+        memcpy(destination + done, stream.Block.data() + offset, count);
+        done += count;
+    }
+
+    return done;
+}
+
+rlas_AssetStream* rlas_OpenStream(const char* path)
+{
+    AssetPtr meta = FindAsset(path);
+    if (meta == nullptr)
+        return nullptr;
+
+    // a stream counts as one load, the bytes and time are added as it is read
+    RecordLoad(*meta, 0, rlas_StatClock());
+
+    rlas_AssetStream* stream = new rlas_AssetStream();
+    stream->Meta = meta;
+    stream->Size = meta->ArchiveInfo.file_size;
+
+    if (meta->ArchiveFile == nullptr)
+    {
+        stream->File = OpenAssetFile(meta->PathOnDisk.c_str(), "rb");
+        if (stream->File != nullptr)
+        {
+            setvbuf(stream->File, nullptr, _IOFBF, StreamFileBufferSize);
+            rlas_FileStamp stamp;
+            if (rlas_GetFileStamp(meta->PathOnDisk.c_str(), &stamp))
+                stream->Size = (uint64_t)stamp.Size;
+            return stream;
+        }
+    }
+    else if (meta->ArchiveFile->IsPack)
+    {
+        stream->Pack = meta->ArchiveFile->OpenPack();
+        if (stream->Pack != nullptr)
+            return stream;
+    }
+    else
+    {
+        std::shared_ptr<miniz_cpp::zip_file> archive = meta->ArchiveFile->Open();
+        if (archive != nullptr)
+        {
+            stream->Owner = archive;
+
+            const miniz_cpp::zip_info& info = meta->ArchiveInfo;
+            stream->Data = (const unsigned char*)archive->entry_data(info);
+            stream->DataSize = info.compress_size;
+
+            if (stream->Data != nullptr && info.compress_type == MZ_DEFLATED)
+            {
+                stream->Deflated = true;
+                stream->Window.resize(TINFL_LZ_DICT_SIZE);
+                RestartInflate(*stream);
+                return stream;
+            }
+
+            if (stream->Data != nullptr && info.compress_type == 0 && info.compress_size == info.file_size)
+                return stream;
+
+            stream->Copy.resize(info.file_size);
+            if (ReadZipEntry(*archive, *meta, stream->Copy.data()))
+            {
+                stream->Data = stream->Copy.data();
+                stream->DataSize = stream->Copy.size();
+                return stream;
+            }
+        }
+    }
+
+    delete stream;
+    return nullptr;
+}
+
+unsigned int rlas_ReadStream(rlas_AssetStream* stream, void* buffer, unsigned int size)
+{
+    if (stream == nullptr || buffer == nullptr || stream->Position >= stream->Size)
+        return 0;
+
+    size_t count = (size_t)std::min<uint64_t>(size, stream->Size - stream->Position);
+    unsigned char* destination = (unsigned char*)buffer;
+    uint64_t start = rlas_StatClock();
+
+    if (stream->File != nullptr)
+    {
+        count = fread(destination, 1, count, stream->File);
+    }
+    else if (stream->Pack != nullptr)
+    {
+        count = ReadPackStream(*stream, destination, count);
+    }
+    else if (stream->Deflated)
+    {
+        rlas_StatTimer timer(Stats.InflateNanoseconds, &Stats.Inflates);
+        count = ReadInflated(*stream, destination, count);
+        rlas_AddStat(Stats.InflatedBytes, count);
+    }
+    else
+    {
+        memcpy(destination, stream->Data + stream->Position, count);
+    }
+
+    RecordRead(*stream->Meta, count, start);
+    stream->Position += count;
+    return (unsigned int)count;
+}
+
+bool rlas_SeekStream(rlas_AssetStream* stream, long long offset, int origin)
+{
+    if (stream == nullptr)
+        return false;
+
+    long long base = origin == SEEK_CUR ? (long long)stream->Position : origin == SEEK_END ? (long long)stream->Size : 0;
+    long long target = base + offset;
+    if (target < 0 || (unsigned long long)target > stream->Size)
+        return false;
+
+    uint64_t position = (uint64_t)target;
+    if (stream->File != nullptr)
+    {
+        if (!SeekFile(stream->File, position))
+            return false;
+    }
+    else if (stream->Deflated)
+    {
+        // deflate can only go forward, going back starts over from the beginning of the entry
+        uint64_t current = stream->Inflated - stream->Pending;
+        if (position < current)
+        {
+            RestartInflate(*stream);
+            current = 0;
+        }
+
+        if (ReadInflated(*stream, nullptr, (size_t)(position - current)) != position - current)
+            return false;
+    }
+
+    stream->Position = position;
+    return true;
+}
+
+unsigned long long rlas_GetStreamPosition(rlas_AssetStream* stream)
+{
+    return stream == nullptr ? 0 : stream->Position;
+}
+
+unsigned long long rlas_GetStreamSize(rlas_AssetStream* stream)
+{
+    return stream == nullptr ? 0 : stream->Size;
+}
+
+void rlas_CloseStream(rlas_AssetStream* stream)
+{
+    delete stream;
+}
+
+struct rlas_AsyncLoadState
+{
+    AssetPtr Meta;
+    bool Text = false;
+    std::atomic<bool> Released;
+    unsigned char* Data = nullptr;
+    unsigned int Size = 0;
+
+    rlas_AsyncLoadState() : Released(false) {}
+
+    ~rlas_AsyncLoadState()
+    {
+        if (Data != nullptr)
+            MemFree(Data);
+    }
+};
+
+struct rlas_AsyncLoad
+{
+    std::shared_ptr<rlas_AsyncLoadState> State;
+    std::shared_future<void> Done;
+};
+
+void RunAsyncLoad(rlas_AsyncLoadState& state)
+{
+    if (state.Released || state.Meta == nullptr)
+        return;
+
+    uint64_t start = rlas_StatClock();
+    try
+    {
+        if (state.Text)
+        {
+            state.Data = (unsigned char*)LoadAssetText(*state.Meta, &state.Size);
+        }
+        else
+        {
+            state.Data = LoadAssetData(*state.Meta, &state.Size);
+        }
+    }
+    catch (...)
+    {
+        state.Data = nullptr;
+        state.Size = 0;
+    }
+
+    RecordLoad(*state.Meta, state.Size, start);
+}
+
+rlas_AsyncLoad* StartAsyncLoad(const char* path, bool text)
+{
+    std::shared_ptr<rlas_AsyncLoadState> state = std::make_shared<rlas_AsyncLoadState>();
+    state->Text = text;
+
+    // the asset is resolved now, so mounts and cleanups made while the load is queued do not affect it
+    state->Meta = FindAsset(path);
+    if (state->Meta == nullptr && path != nullptr && FileExists(path))
+    {
+        std::shared_ptr<rlas_AssetMeta> file = std::make_shared<rlas_AssetMeta>();
+        file->PathOnDisk = path;
+        state->Meta = file;
+    }
+
+    std::shared_ptr<std::packaged_task<void()>> task = std::make_shared<std::packaged_task<void()>>([state]() { RunAsyncLoad(*state); });
+
+    rlas_AsyncLoad* load = new rlas_AsyncLoad();
+    load->State = state;
+    load->Done = task->get_future().share();
+
+    if (state->Meta == nullptr)
+        (*task)();  // nothing to load, complete right away
+    else
+        AssetWorkers.Push([task]() { (*task)(); });
+
+    return load;
+}
+
+rlas_AsyncLoad* rlas_LoadAsync(const char* path)
+{
+    return StartAsyncLoad(path, false);
+}
+
+rlas_AsyncLoad* rlas_LoadTextAsync(const char* path)
+{
+    return StartAsyncLoad(path, true);
+}
+
+bool rlas_IsAsyncLoadDone(rlas_AsyncLoad* load)
+{
+    if (load == nullptr)
+        return true;
+
+    return load->Done.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void rlas_WaitAsyncLoad(rlas_AsyncLoad* load)
+{
+    if (load != nullptr)
+        load->Done.wait();
+}
+
+unsigned char* rlas_TakeAsyncLoadData(rlas_AsyncLoad* load, unsigned int* bytesRead)
+{
+    if (bytesRead != nullptr)
+        *bytesRead = 0;
+
+    if (load == nullptr)
+        return nullptr;
+
+    load->Done.wait();
+
+    unsigned char* data = load->State->Data;
+    if (bytesRead != nullptr)
+        *bytesRead = load->State->Size;
+
+    load->State->Data = nullptr;
+    load->State->Size = 0;
+    return data;
+}
+
+void rlas_ReleaseAsyncLoad(rlas_AsyncLoad* load)
+{
+    if (load == nullptr)
+        return;
+
+    // a load that has not started yet is skipped, one in progress frees its data when it finishes
+    load->State->Released = true;
+    delete load;
+}
+
+// a batch of loads shared by the calling thread and the workers, each one takes the next asset until none are left
+struct rlas_BatchLoad
+{
+    std::vector<AssetPtr> Assets;
+    std::vector<size_t> Order;      // asset indexes sorted by archive and position in the archive
+    unsigned char** Data = nullptr;
+    unsigned int* Sizes = nullptr;
+
+    std::atomic<size_t> Next;
+    std::mutex Lock;
+    std::condition_variable Done;
+    size_t Pending = 0;
+
+    rlas_BatchLoad() : Next(0) {}
+
+    void Run()
+    {
+        for (;;)
+        {
+            // a worker that starts after every asset was taken returns without touching the outputs
+            size_t next = Next++;
+            if (next >= Order.size())
+                return;
+
+            size_t index = Order[next];
+            uint64_t start = rlas_StatClock();
+            try
+            {
+                Data[index] = LoadAssetData(*Assets[index], &Sizes[index]);
+            }
+            catch (...)
+            {
+                Data[index] = nullptr;
+                Sizes[index] = 0;
+            }
+            RecordLoad(*Assets[index], Sizes[index], start);
+
+            std::unique_lock<std::mutex> lock(Lock);
+            --Pending;
+            if (Pending == 0)
+                Done.notify_all();
+        }
+    }
+};
+
+int rlas_LoadBatch(const char** paths, int count, unsigned char** data, unsigned int* sizes)
+{
+    if (paths == nullptr || data == nullptr || sizes == nullptr || count <= 0)
+        return 0;
+
+    std::shared_ptr<rlas_BatchLoad> batch = std::make_shared<rlas_BatchLoad>();
+    batch->Data = data;
+    batch->Sizes = sizes;
+    batch->Assets.resize(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        data[i] = nullptr;
+        sizes[i] = 0;
+
+        AssetPtr meta = FindAsset(paths[i]);
+        if (meta == nullptr && paths[i] != nullptr && FileExists(paths[i]))
+        {
+            std::shared_ptr<rlas_AssetMeta> file = std::make_shared<rlas_AssetMeta>();
+            file->PathOnDisk = paths[i];
+            meta = file;
+        }
+
+        if (meta == nullptr)
+            continue;
+
+        batch->Assets[i] = meta;
+        batch->Order.push_back(i);
+    }
+
+    // entries of one archive are taken in the order they are stored, so the archive is read front to back
+    std::sort(batch->Order.begin(), batch->Order.end(), [&batch](size_t a, size_t b)
+    {
+        const rlas_AssetMeta& left = *batch->Assets[a];
+        const rlas_AssetMeta& right = *batch->Assets[b];
+        if (left.ArchiveFile != right.ArchiveFile)
+            return left.ArchiveFile < right.ArchiveFile;
+
+        uint64_t leftOffset = left.ArchiveFile != nullptr && left.ArchiveFile->IsPack ? left.PackEntry : left.ArchiveInfo.header_offset;
+        uint64_t rightOffset = right.ArchiveFile != nullptr && right.ArchiveFile->IsPack ? right.PackEntry : right.ArchiveInfo.header_offset;
+        return leftOffset < rightOffset;
+    });
+
+    batch->Pending = batch->Order.size();
+    if (batch->Pending == 0)
+        return 0;
+
+    // archive reads do not share any decompression state, so every thread can inflate entries of the same archive at once
+    size_t helpers = std::min<size_t>((size_t)AssetWorkers.GetThreadCount(), batch->Pending - 1);
+    for (size_t i = 0; i < helpers; ++i)
+        AssetWorkers.Push([batch]() { batch->Run(); });
+
+    batch->Run();
+
+    std::unique_lock<std::mutex> lock(batch->Lock);
+    batch->Done.wait(lock, [&batch]() { return batch->Pending == 0; });
+
+    int loaded = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (data[i] != nullptr)
+            ++loaded;
+    }
+    return loaded;
+}
+
+void rlas_SetAsyncLoadThreads(int count)
+{
+    AssetWorkers.SetThreadCount(count);
+}
+
+void rlas_SetArchiveCacheBudget(unsigned long long bytes)
+{
+    ArchiveCache.SetBudget(bytes);
+}
+
+void rlas_ClearArchiveCache()
+{
+    ArchiveCache.Clear();
+}
+
+rlas_ArchiveCacheStats rlas_GetArchiveCacheStats()
+{
+    rlas_DataCache::Stats stats = ArchiveCache.GetStats();
+
+    rlas_ArchiveCacheStats result;
+    result.hits = stats.Hits;
+    result.misses = stats.Misses;
+    result.evictions = stats.Evictions;
+    result.bytesUsed = stats.BytesUsed;
+    result.budget = stats.Budget;
+    result.entries = stats.Items;
+    return result;
+}
+
+void rlas_SetStatsEnabled(bool enabled)
+{
+    StatsEnabled = enabled;
+}
+
+rlas_Stats rlas_GetStats()
+{
+    rlas_Stats result;
+    result.lookups = rlas_ReadStat(Stats.Lookups);
+    result.lookupMisses = rlas_ReadStat(Stats.LookupMisses);
+    result.lookupHits = result.lookups - std::min(result.lookups, result.lookupMisses);
+    result.loads = rlas_ReadStat(Stats.Loads);
+    result.bytesFromDisk = rlas_ReadStat(Stats.DiskBytes);
+    result.bytesFromArchives = rlas_ReadStat(Stats.ArchiveBytes);
+    result.fileOpens = rlas_ReadStat(Stats.FileOpens);
+    result.fileOpenSeconds = rlas_ReadStat(Stats.FileOpenNanoseconds) / 1e9;
+    result.inflates = rlas_ReadStat(Stats.Inflates);
+    result.inflatedBytes = rlas_ReadStat(Stats.InflatedBytes);
+    result.inflateSeconds = rlas_ReadStat(Stats.InflateNanoseconds) / 1e9;
+    result.tempExtractions = rlas_ReadStat(Stats.TempExtractions);
+    result.tempExtractionBytes = rlas_ReadStat(Stats.TempExtractionBytes);
+    result.imageCacheHits = rlas_ReadStat(Stats.ImageCacheHits);
+    result.imageCacheMisses = rlas_ReadStat(Stats.ImageCacheMisses);
+    return result;
+}
+
+void ReadAssetStats(const rlas_AssetMeta& meta, rlas_AssetStats* stats)
+{
+    stats->lookups = rlas_ReadStat(meta.Counters.Lookups);
+    stats->loads = rlas_ReadStat(meta.Counters.Loads);
+    stats->bytes = rlas_ReadStat(meta.Counters.Bytes);
+    stats->loadSeconds = rlas_ReadStat(meta.Counters.LoadNanoseconds) / 1e9;
+}
+
+bool rlas_GetAssetStats(const char* path, rlas_AssetStats* stats)
+{
+    if (path == nullptr || stats == nullptr)
+        return false;
+
+    // looked up directly so reading the stats does not count as a lookup
+    LayersPtr layers = GetAssetLayers();
+    const AssetPtr* meta = FindInTable(*layers, path);
+    if (meta == nullptr)
+        return false;
+
+    ReadAssetStats(**meta, stats);
+    return true;
+}
+
+void rlas_ResetStats()
+{
+    Stats.Reset();
+
+    ForEachIndex(*GetAssetLayers(), [](const rlas_AssetTable& index)
+    {
+        for (size_t i = 0; i < index.Assets.Size(); ++i)
+            index.Assets.ItemAt(i)->Counters.Reset();
+    });
+}
+
+void WriteQuoted(FILE* file, const std::string& text, bool csv)
+{
+    fputc('"', file);
+    for (char c : text)
+    {
+        if (c == '"')
+            fputs(csv ? "\"\"" : "\\\"", file);
+        else if (c == '\\' && !csv)
+            fputs("\\\\", file);
+        else if ((unsigned char)c < 0x20 && !csv)
+            fprintf(file, "\\u%04x", c);
+        else
+            fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+bool rlas_SaveStats(const char* fileName)
+{
+    if (fileName == nullptr)
+        return false;
+
+    bool csv = HasExtension(fileName, ".csv");
+    rlas_Stats stats = rlas_GetStats();
+
+    const char* names[] = { "lookups", "lookupHits", "lookupMisses", "loads", "bytesFromDisk", "bytesFromArchives", "fileOpens", "inflates", "inflatedBytes", "tempExtractions", "tempExtractionBytes", "imageCacheHits", "imageCacheMisses" };
+    unsigned long long counts[] = { stats.lookups, stats.lookupHits, stats.lookupMisses, stats.loads, stats.bytesFromDisk, stats.bytesFromArchives, stats.fileOpens, stats.inflates, stats.inflatedBytes, stats.tempExtractions, stats.tempExtractionBytes, stats.imageCacheHits, stats.imageCacheMisses };
+
+    // written under a temp name and renamed, so a failed write leaves the last dump whole
+    return ReplaceFileWith(fileName, [&](FILE* file)
+    {
+        // CSV has the totals as name,value rows, then a table of assets, JSON has an object with an array of assets
+        if (csv)
+        {
+            fputs("stat,value\n", file);
+            for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+                fprintf(file, "%s,%llu\n", names[i], counts[i]);
+            fprintf(file, "fileOpenSeconds,%.9f\ninflateSeconds,%.9f\n\npath,lookups,loads,bytes,loadSeconds\n", stats.fileOpenSeconds, stats.inflateSeconds);
+        }
+        else
+        {
+            fputs("{\n", file);
+            for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+                fprintf(file, "  \"%s\": %llu,\n", names[i], counts[i]);
+            fprintf(file, "  \"fileOpenSeconds\": %.9f,\n  \"inflateSeconds\": %.9f,\n  \"assets\": [", stats.fileOpenSeconds, stats.inflateSeconds);
+        }
+
+        // only assets that were used are written
+        bool first = true;
+        ForEachIndex(*GetAssetLayers(), [&](const rlas_AssetTable& index)
+        {
+            for (size_t i = 0; i < index.Assets.Size(); ++i)
+            {
+                rlas_AssetStats asset;
+                ReadAssetStats(*index.Assets.ItemAt(i), &asset);
+                if (asset.lookups == 0 && asset.loads == 0)
+                    continue;
+
+                if (!csv)
+                    fputs(first ? "\n    { \"path\": " : ",\n    { \"path\": ", file);
+                WriteQuoted(file, index.Assets.NameAt(i), csv);
+                if (csv)
+                    fprintf(file, ",%llu,%llu,%llu,%.9f\n", asset.lookups, asset.loads, asset.bytes, asset.loadSeconds);
+                else
+                    fprintf(file, ", \"lookups\": %llu, \"loads\": %llu, \"bytes\": %llu, \"loadSeconds\": %.9f }", asset.lookups, asset.loads, asset.bytes, asset.loadSeconds);
+                first = false;
+            }
+        });
+
+        if (!csv)
+            fputs(first ? "]\n}\n" : "\n  ]\n}\n", file);
+
+        return ferror(file) == 0;
+    });
+}
+
+struct rlas_PrefetchState
+{
+    int Assets = 0;
+    std::atomic<int> AssetsDone;
+    std::atomic<unsigned long long> Bytes;
+    std::atomic<int> RunsLeft;      // the number of worker jobs that have not finished
+    std::atomic<bool> Cancelled;
+
+    rlas_PrefetchState() : AssetsDone(0), Bytes(0), RunsLeft(0), Cancelled(false) {}
+};
+
+typedef std::shared_ptr<rlas_PrefetchState> PrefetchPtr;
+
+// guards the groups and the last prefetch of each group
+std::mutex PrefetchLock;
+std::map<std::string, std::vector<std::string>> PrefetchGroups;
+std::map<std::string, PrefetchPtr> Prefetches;
+
+static const size_t PrefetchChunkSize = 256 * 1024;
+
+// '*' stays in one path part, '**' also matches across parts
+bool MatchPathPattern(const char* pattern, const char* name)
+{
+    for (; *pattern != '\0'; ++pattern, ++name)
+    {
+        if (*pattern == '*')
+        {
+            bool anyPart = pattern[1] == '*';
+            pattern += anyPart ? 2 : 1;
+            for (;; ++name)
+            {
+                if (MatchPathPattern(pattern, name))
+                    return true;
+
+                if (*name == '\0' || (*name == '/' && !anyPart))
+                    return false;
+            }
+        }
+
+        if (*name == '\0')
+            return false;
+
+        if (*pattern == '?' ? *name == '/' : rlas_FoldPathChar(*pattern) != rlas_FoldPathChar(*name))
+            return false;
+    }
+
+    return *name == '\0';
+}
+
+// reads an asset and throws the data away, which leaves it in the OS file cache
+void PrefetchAsset(const rlas_AssetMeta& meta, rlas_PrefetchState& state, std::vector<unsigned char>& scratch)
+{
+    if (meta.ArchiveFile == nullptr)
+    {
+        uint64_t size = 0;
+        int file = OpenReadFile(meta.PathOnDisk.c_str(), &size);
+        if (file < 0)
+            return;
+
+        size_t read = 0;
+        for (uint64_t offset = 0; !state.Cancelled && (read = rlas_ReadFileAt(file, offset, scratch.data(), scratch.size())) > 0; offset += read)
+            state.Bytes += read;
+
+        rlas_CloseReadFile(file);
+        return;
+    }
+
+    if (meta.ArchiveFile->IsPack)
+    {
+        uint64_t offset = 0;
+        while (!state.Cancelled && offset < meta.ArchiveInfo.file_size)
+        {
+            size_t read = ReadAssetRange(meta, offset, scratch.data(), scratch.size());
+            if (read == 0)
+                break;
+
+            offset += read;
+            state.Bytes += read;
+        }
+        return;
+    }
+
+    // compressed entries go into the archive cache when it is enabled
+    rlas_DataCache::Data cached = GetCachedArchiveData(meta);
+    if (cached != nullptr)
+    {
+        state.Bytes += cached->size();
+        return;
+    }
+
+    std::shared_ptr<miniz_cpp::zip_file> archive = meta.ArchiveFile->Open();
+    const unsigned char* data = archive != nullptr ? (const unsigned char*)archive->entry_data(meta.ArchiveInfo) : nullptr;
+    if (data == nullptr)
+        return;
+
+    // touching a byte in every page has the OS read the entry in from a mapped archive
+    unsigned int sum = 0;
+    size_t size = (size_t)meta.ArchiveInfo.compress_size;
+    for (size_t i = 0; i < size && !state.Cancelled; i += 4096)
+        sum += data[i];
+
+    volatile unsigned int touched = sum;
+    (void)touched;
+    state.Bytes += size;
+}
+
+// runs on a worker, assets is all loose files or all from one archive
+void RunPrefetch(std::vector<AssetPtr>& assets, rlas_PrefetchState& state)
+{
+    if (!state.Cancelled && !assets.empty() && assets.front()->ArchiveFile != nullptr)
+    {
+        // reading in the order entries are stored turns random reads into one sequential pass over the archive
+        std::shared_ptr<rlas_PackFile> pack = assets.front()->ArchiveFile->OpenPack();
+        auto offset = [&pack](const AssetPtr& meta) -> uint64_t
+        {
+            return pack != nullptr ? pack->EntryAt(meta->PackEntry).FirstBlock : meta->ArchiveInfo.header_offset;
+        };
+
+        std::sort(assets.begin(), assets.end(), [&offset](const AssetPtr& a, const AssetPtr& b) { return offset(a) < offset(b); });
+    }
+
+    std::vector<unsigned char> scratch(PrefetchChunkSize);
+    for (auto& meta : assets)
+    {
+        if (state.Cancelled)
+            break;
+
+        try
+        {
+            PrefetchAsset(*meta, state, scratch);
+        }
+        catch (...)
+        {
+        }
+
+        ++state.AssetsDone;
+    }
+
+    --state.RunsLeft;
+}
+
+void CancelPrefetches()
+{
+    std::lock_guard<std::mutex> lock(PrefetchLock);
+    for (auto& prefetch : Prefetches)
+        prefetch.second->Cancelled = true;
+
+    Prefetches.clear();
+    PrefetchGroups.clear();
+}
+
+void rlas_AddPrefetchGroupPath(const char* group, const char* pattern)
+{
+    if (group == nullptr || pattern == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(PrefetchLock);
+    PrefetchGroups[group].push_back(pattern);
+}
+
+void rlas_RemovePrefetchGroup(const char* group)
+{
+    if (group == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(PrefetchLock);
+    PrefetchGroups.erase(group);
+
+    auto prefetch = Prefetches.find(group);
+    if (prefetch != Prefetches.end())
+    {
+        prefetch->second->Cancelled = true;
+        Prefetches.erase(prefetch);
+    }
+}
+
+bool rlas_PrefetchGroup(const char* group)
+{
+    if (group == nullptr)
+        return false;
+
+    std::vector<std::string> patterns;
+    {
+        std::lock_guard<std::mutex> lock(PrefetchLock);
+        auto existing = PrefetchGroups.find(group);
+        if (existing == PrefetchGroups.end())
+            return false;
+
+        patterns = existing->second;
+    }
+
+    // lazy directories a pattern can reach are read first, a pattern with a wildcard reads everything below its last plain directory
+    LayersPtr layers = GetAssetLayers();
+    for (auto& pattern : patterns)
+    {
+        if (layers->Table->Lazy.Size() == 0)
+            break;
+
+        size_t wildcard = pattern.find_first_of("*?");
+        if (wildcard == std::string::npos)
+        {
+            layers = IndexLazyParents(layers, pattern.c_str());
+            continue;
+        }
+
+        size_t slash = pattern.find_last_of('/', wildcard);
+        layers = IndexLazyTree(layers, slash == std::string::npos ? std::string() : pattern.substr(0, slash), true);
+    }
+
+    // loose files are one run, each archive is a run of its own
+    std::map<const rlas_ArchiveFile*, std::vector<AssetPtr>> runs;
+    std::set<const rlas_AssetMeta*> added;
+    int count = 0;
+
+    auto add = [&](const AssetPtr& meta)
+    {
+        if (added.insert(meta.get()).second)
+        {
+            runs[meta->ArchiveFile.get()].push_back(meta);
+            ++count;
+        }
+    };
+
+    for (auto& pattern : patterns)
+    {
+        if (pattern.find_first_of("*?") == std::string::npos)
+        {
+            const AssetPtr* meta = FindInTable(*layers, pattern.c_str());
+            if (meta != nullptr)
+                add(*meta);
+            continue;
+        }
+
+        if (layers->Mounts.empty())
+        {
+            const rlas_AssetTable& table = *layers->Table;
+            for (size_t i = 0; i < table.Assets.Size(); ++i)
+            {
+                if (MatchPathPattern(pattern.c_str(), table.Assets.NameAt(i).c_str()))
+                    add(table.Assets.ItemAt(i));
+            }
+            continue;
+        }
+
+        // mounts below the last plain directory of the pattern are read to match against
+        size_t slash = pattern.find_last_of('/', pattern.find_first_of("*?"));
+        VisitAssets(*layers, slash == std::string::npos ? std::string() : pattern.substr(0, slash), true, [&](const AssetPtr& meta)
+            {
+                if (MatchPathPattern(pattern.c_str(), meta->RelativeName.c_str()))
+                    add(meta);
+                return true;
+            });
+    }
+
+    PrefetchPtr state = std::make_shared<rlas_PrefetchState>();
+    state->Assets = count;
+    state->RunsLeft = (int)runs.size();
+
+    {
+        std::lock_guard<std::mutex> lock(PrefetchLock);
+        PrefetchPtr& current = Prefetches[group];
+        if (current != nullptr)
+            current->Cancelled = true;
+        current = state;
+    }
+
+    for (auto& run : runs)
+    {
+        std::shared_ptr<std::vector<AssetPtr>> assets = std::make_shared<std::vector<AssetPtr>>(std::move(run.second));
+        AssetWorkers.Push([assets, state]() { RunPrefetch(*assets, *state); });
+    }
+
+    return true;
+}
+
+bool rlas_GetPrefetchProgress(const char* group, rlas_PrefetchProgress* progress)
+{
+    if (group == nullptr || progress == nullptr)
+        return false;
+
+    PrefetchPtr state;
+    {
+        std::lock_guard<std::mutex> lock(PrefetchLock);
+        auto existing = Prefetches.find(group);
+        if (existing == Prefetches.end())
+            return false;
+
+        state = existing->second;
+    }
+
+    progress->assets = state->Assets;
+    progress->assetsDone = state->AssetsDone;
+    progress->bytes = state->Bytes;
+    progress->finished = state->RunsLeft == 0;
+    progress->cancelled = state->Cancelled && progress->assetsDone < progress->assets;
+    return true;
+}
+
+void rlas_CancelPrefetch(const char* group)
+{
+    if (group == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(PrefetchLock);
+    auto existing = Prefetches.find(group);
+    if (existing != Prefetches.end())
+        existing->second->Cancelled = true;
+}
+
+static const char ManifestMagic[4] = { 'R', 'L', 'A', 'M' };
+static const uint32_t ManifestVersion = 6;
+static const uint32_t ManifestByteOrder = 0x01020304;
+
+enum rlas_ManifestSource : uint8_t
+{
+    ManifestSourceFile = 0,
+    ManifestSourceArchive = 1,
+    ManifestSourcePack = 2,
+};
+
+void WriteStamp(rlas_BinaryWriter& writer, const rlas_FileStamp& stamp)
+{
+    writer.Write(stamp.Size);
+    writer.Write(stamp.ModTime);
+}
+
+bool ReadStamp(rlas_BinaryReader& reader, rlas_FileStamp& stamp)
+{
+    reader.Read(stamp.Size);
+    return reader.Read(stamp.ModTime);
+}
+
+void rlas_SetAssetManifestPath(const char* fileName)
+{
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    if (fileName == nullptr)
+        AssetManifestPath.clear();
+    else
+        AssetManifestPath = fileName;
+}
+
+// the caller must hold the mount lock
+bool SaveAssetManifest(const char* fileName)
+{
+    if (fileName == nullptr)
+        return false;
+
+    TablePtr table = CopyAssetTable();
+
+    rlas_BinaryWriter writer;
+    writer.WriteBytes(ManifestMagic, sizeof(ManifestMagic));
+    writer.Write(ManifestVersion);
+    writer.Write(ManifestByteOrder);
+
+    writer.Write((uint32_t)AssetRootPaths.size());
+    for (auto& root : AssetRootPaths)
+        writer.WriteString(root);
+
+    writer.Write((uint32_t)IndexedDirectories.size());
+    for (auto& directory : IndexedDirectories)
+    {
+        writer.WriteString(directory.Path);
+        writer.WriteString(directory.RelPath);
+        writer.Write(directory.Mount);
+        WriteStamp(writer, directory.Stamp);
+    }
+
+    std::map<const rlas_ArchiveFile*, uint32_t> archiveIndexes;
+    writer.Write((uint32_t)IndexedArchives.size());
+    for (auto& archive : IndexedArchives)
+    {
+        archiveIndexes[archive.get()] = (uint32_t)archiveIndexes.size();
+        writer.WriteString(archive->Path);
+        WriteStamp(writer, archive->Stamp);
+        writer.WriteString(archive->RelPath);
+        writer.Write(archive->Mount);
+    }
+
+    writer.Write((uint32_t)table->Assets.Size());
+    for (size_t i = 0; i < table->Assets.Size(); ++i)
+    {
+        const rlas_AssetMeta& meta = *table->Assets.ItemAt(i);
+        writer.WriteString(meta.RelativeName);
+        writer.Write(meta.Mount);
+
+        if (meta.ArchiveFile != nullptr && meta.ArchiveFile->IsPack)
+        {
+            writer.Write((uint8_t)ManifestSourcePack);
+            writer.Write(archiveIndexes[meta.ArchiveFile.get()]);
+            writer.WriteString(meta.ArchiveInfo.filename);
+            writer.Write((uint64_t)meta.ArchiveInfo.file_size);
+            writer.Write(meta.ArchiveInfo.crc);
+            writer.Write(meta.PackEntry);
+        }
+        else if (meta.ArchiveFile != nullptr)
+        {
+            const miniz_cpp::zip_info& info = meta.ArchiveInfo;
+            writer.Write((uint8_t)ManifestSourceArchive);
+            writer.Write(archiveIndexes[meta.ArchiveFile.get()]);
+            writer.WriteString(info.filename);
+            writer.Write((uint64_t)info.header_offset);
+            writer.Write((uint64_t)info.compress_size);
+            writer.Write((uint64_t)info.file_size);
+            writer.Write(info.crc);
+            writer.Write(info.compress_type);
+            writer.Write(info.flag_bits);
+            writer.Write((int32_t)info.file_index);
+        }
+        else
+        {
+            writer.Write((uint8_t)ManifestSourceFile);
+            writer.WriteString(meta.PathOnDisk);
+        }
+    }
+
+    // lazy directories stay lazy, the stamp of the directory that holds one covers it
+    std::vector<const rlas_LazySource*> lazySources;
+    for (size_t i = 0; i < table->Lazy.Size(); ++i)
+    {
+        for (auto& source : table->Lazy.ItemAt(i)->Sources)
+            lazySources.push_back(&source);
+    }
+
+    writer.Write((uint32_t)lazySources.size());
+    for (auto source : lazySources)
+    {
+        writer.WriteString(source->Path);
+        writer.WriteString(source->RelPath);
+        writer.Write(source->Mount);
+        writer.Write((uint8_t)(source->IsArchive ? 1 : 0));
+    }
+
+    // a save cut short by a crash or a full disk leaves the last manifest in place instead of a truncated one
+    return ReplaceFileWith(fileName, [&writer](FILE* file)
+    {
+        return fwrite(writer.Buffer.data(), 1, writer.Buffer.size(), file) == writer.Buffer.size();
+    });
+}
+
+bool rlas_SaveAssetManifest(const char* fileName)
+{
+    std::lock_guard<std::mutex> lock(MountLock);
+    return SaveAssetManifest(fileName);
+}
+
+// the caller must hold the mount lock
+bool LoadAssetManifest(const char* fileName, const std::string* requiredRoot)
+{
+    if (fileName == nullptr || !FileExists(fileName))
+        return false;
+
+    unsigned int size = 0;
+    unsigned char* data = (unsigned char*)ReadFileContents(fileName, &size, true);
+    if (data == nullptr)
+        return false;
+
+    rlas_BinaryReader reader(data, size);
+
+    char magic[4] = { 0 };
+    uint32_t version = 0;
+    uint32_t byteOrder = 0;
+    reader.ReadBytes(magic, sizeof(magic));
+    reader.Read(version);
+    reader.Read(byteOrder);
+
+    bool valid = reader.Ok() && memcmp(magic, ManifestMagic, sizeof(magic)) == 0 && version == ManifestVersion && byteOrder == ManifestByteOrder;
+
+    uint32_t count = 0;
+    std::vector<std::string> roots;
+    if (valid && reader.Read(count))
+    {
+        roots.resize(count);
+        for (auto& root : roots)
+            reader.ReadString(root);
+    }
+
+    if (requiredRoot != nullptr && (roots.size() != 1 || roots[0] != *requiredRoot))
+        valid = false;
+
+    // the directory and archive stamps are what make the manifest cheap to check, any change on disk means the manifest is out of date
+    std::vector<rlas_IndexedDirectory> directories;
+    if (valid && reader.Read(count))
+    {
+        directories.resize(count);
+        for (auto& directory : directories)
+        {
+            rlas_FileStamp current;
+            reader.ReadString(directory.Path);
+            reader.ReadString(directory.RelPath);
+            reader.Read(directory.Mount);
+            if (!ReadStamp(reader, directory.Stamp)
+                || !rlas_GetFileStamp(directory.Path.c_str(), &current) || current.ModTime != directory.Stamp.ModTime)
+            {
+                valid = false;
+                break;
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<rlas_ArchiveFile>> archives;
+    if (valid && reader.Read(count))
+    {
+        archives.reserve(count);
+        for (uint32_t i = 0; i < count && valid; ++i)
+        {
+            std::string path;
+            rlas_FileStamp stamp;
+            reader.ReadString(path);
+            ReadStamp(reader, stamp);
+
+            std::shared_ptr<rlas_ArchiveFile> archive = std::make_shared<rlas_ArchiveFile>(path);
+            reader.ReadString(archive->RelPath);
+            reader.Read(archive->Mount);
+            valid = reader.Ok() && archive->Stamp.Size == stamp.Size && archive->Stamp.ModTime == stamp.ModTime;
+            archives.push_back(archive);
+        }
+    }
+
+    std::vector<std::shared_ptr<rlas_AssetMeta>> assets;
+    if (valid && reader.Read(count))
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            assets.push_back(std::make_shared<rlas_AssetMeta>());
+            rlas_AssetMeta& meta = *assets.back();
+
+            uint8_t source = 0;
+            reader.ReadString(meta.RelativeName);
+            reader.Read(meta.Mount);
+            reader.Read(source);
+
+            if (source == ManifestSourcePack)
+            {
+                uint32_t archiveIndex = 0;
+                uint64_t fileSize = 0;
+
+                reader.Read(archiveIndex);
+                reader.ReadString(meta.ArchiveInfo.filename);
+                reader.Read(fileSize);
+                reader.Read(meta.ArchiveInfo.crc);
+                reader.Read(meta.PackEntry);
+
+                if (archiveIndex >= archives.size() || !archives[archiveIndex]->IsPack)
+                {
+                    valid = false;
+                    break;
+                }
+
+                meta.ArchiveInfo.file_size = (size_t)fileSize;
+                meta.ArchiveFile = archives[archiveIndex];
+                meta.PathOnDisk = meta.ArchiveFile->Path;
+            }
+            else if (source == ManifestSourceArchive)
+            {
+                uint32_t archiveIndex = 0;
+                uint64_t headerOffset = 0, compressSize = 0, fileSize = 0;
+                int32_t fileIndex = -1;
+                miniz_cpp::zip_info& info = meta.ArchiveInfo;
+
+                reader.Read(archiveIndex);
+                reader.ReadString(info.filename);
+                reader.Read(headerOffset);
+                reader.Read(compressSize);
+                reader.Read(fileSize);
+                reader.Read(info.crc);
+                reader.Read(info.compress_type);
+                reader.Read(info.flag_bits);
+                reader.Read(fileIndex);
+
+                if (archiveIndex >= archives.size() || archives[archiveIndex]->IsPack)
+                {
+                    valid = false;
+                    break;
+                }
+
+                info.header_offset = (size_t)headerOffset;
+                info.compress_size = (size_t)compressSize;
+                info.file_size = (size_t)fileSize;
+                info.file_index = fileIndex;
+                meta.ArchiveFile = archives[archiveIndex];
+                meta.PathOnDisk = meta.ArchiveFile->Path;
+            }
+            else
+            {
+                // only directory stamps are checked and editing a file in place does not change its directory,
+                // so files are left without a stamp and their size is read from disk
+                reader.ReadString(meta.PathOnDisk);
+            }
+
+            if (!reader.Ok())
+            {
+                valid = false;
+                break;
+            }
+        }
+    }
+
+    std::vector<rlas_LazySource> lazySources;
+    if (valid && reader.Read(count))
+    {
+        lazySources.resize(count);
+        for (auto& source : lazySources)
+        {
+            uint8_t isArchive = 0;
+            reader.ReadString(source.Path);
+            reader.ReadString(source.RelPath);
+            reader.Read(source.Mount);
+            reader.Read(isArchive);
+            source.IsArchive = isArchive != 0;
+
+            if (!reader.Ok() || source.RelPath.empty())
+            {
+                valid = false;
+                break;
+            }
+        }
+    }
+
+    MemFree(data);
+
+    if (!valid || !reader.Ok())
+        return false;
+
+    SetLoadFileDataCallback(LoadBinFile);
+    SetLoadFileTextCallback(LoadTextFile);
+
+    std::shared_ptr<rlas_AssetTable> table = std::make_shared<rlas_AssetTable>();
+    for (auto& meta : assets)
+        SetAsset(*table, meta->RelativeName, meta);
+    for (auto& source : lazySources)
+        AddLazySource(*table, source);
+    LayersPtr layers = PublishAssetTable(table);
+
+    AssetRootPaths = roots;
+    IndexedDirectories = directories;
+    IndexedArchives = archives;
+
+    MountCount = 0;
+    for (auto& directory : IndexedDirectories)
+        MountCount = std::max(MountCount, directory.Mount);
+    for (auto& meta : assets)
+        MountCount = std::max(MountCount, meta->Mount);
+    for (auto& mount : layers->Mounts)
+        MountCount = std::max(MountCount, mount->Id);
+
+    ResetDirectoryWatcher();
+    WatchIndexedDirectories();
+
+    return true;
+}
+
+bool rlas_LoadAssetManifest(const char* fileName)
+{
+    std::lock_guard<std::mutex> lock(MountLock);
+    return LoadAssetManifest(fileName, nullptr);
+}
+
+// decoded images are kept as one file per image in the image cache path, named by the hash of the asset's virtual path
+static const char ImageCacheMagic[4] = { 'R', 'L', 'A', 'I' };
+static const uint32_t ImageCacheVersion = 1;
+static const size_t ImageCacheAlignment = 64;       // the pixels start at a multiple of this so the read of them is aligned, they are always copied since UnloadImage frees them
+static const size_t ImageCacheHeaderRead = 4096;    // the first read of a cache file, enough for the header of any sensible path
+
+// guards the image cache path, cache files are shared with other processes through write and rename
+std::mutex ImageCacheLock;
+std::string ImageCachePath;
+
+void rlas_SetImageCachePath(const char* path)
+{
+    std::lock_guard<std::mutex> lock(ImageCacheLock);
+
+    ImageCachePath = path == nullptr ? std::string() : path;
+    if (ImageCachePath.empty())
+        return;
+
+    rlas_CreateDirectory(ImageCachePath.c_str());
+    if (ImageCachePath.back() != '/' && ImageCachePath.back() != PathDelim)
+        ImageCachePath += PathDelim;
+}
+
+// what a cached image has to match, the size and modification time of a loose file or the size and crc of an archive entry
+// loose files are stamped again instead of using the index, so a file changed without the watcher is still decoded again
+bool GetImageSource(const rlas_AssetMeta& meta, rlas_FileStamp& source)
+{
+    if (meta.ArchiveFile != nullptr)
+    {
+        source.Size = (int64_t)meta.ArchiveInfo.file_size;
+        source.ModTime = (int64_t)meta.ArchiveInfo.crc;
+        return true;
+    }
+
+    return rlas_GetFileStamp(meta.PathOnDisk.c_str(), &source);
+}
+
+// the size of the pixels of every mip level, 0 if the image does not make sense
+uint64_t GetImageDataSize(int width, int height, int mipmaps, int format)
+{
+    if (width <= 0 || height <= 0 || mipmaps <= 0 || mipmaps > 32)
+        return 0;
+
+    uint64_t size = 0;
+    for (int level = 0; level < mipmaps; ++level)
+    {
+        size += (uint64_t)std::max(GetPixelDataSize(width, height, format), 0);
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    return size;
+}
+
+size_t AlignImageData(size_t offset)
+{
+    return (offset + ImageCacheAlignment - 1) & ~(ImageCacheAlignment - 1);
+}
+
+// a cache file is a small header with the virtual path and the source it was decoded from, then the raw pixels of every mip level
+void WriteImageHeader(rlas_BinaryWriter& writer, const rlas_AssetMeta& meta, const rlas_FileStamp& source, const Image& image, uint64_t dataSize)
+{
+    writer.WriteBytes(ImageCacheMagic, sizeof(ImageCacheMagic));
+    writer.Write(ImageCacheVersion);
+    writer.Write(ManifestByteOrder);
+    writer.WriteString(meta.RelativeName);
+    writer.Write((uint8_t)(meta.ArchiveFile != nullptr ? 1 : 0));
+    WriteStamp(writer, source);
+    writer.Write((int32_t)image.width);
+    writer.Write((int32_t)image.height);
+    writer.Write((int32_t)image.mipmaps);
+    writer.Write((int32_t)image.format);
+    writer.Write(dataSize);
+    writer.Buffer.resize(AlignImageData(writer.Buffer.size()), 0);
+}
+
+// reads the pixels of a cache file if it was written for the same asset and source, anything else is a miss
+bool ReadCachedImage(const std::string& fileName, const rlas_AssetMeta& meta, const rlas_FileStamp& source, Image& image)
+{
+    uint64_t fileSize = 0;
+    int file = OpenReadFile(fileName.c_str(), &fileSize);
+    if (file < 0)
+        return false;
+
+    unsigned char header[ImageCacheHeaderRead];
+    size_t headerSize = rlas_ReadFileAt(file, 0, header, (size_t)std::min<uint64_t>(fileSize, sizeof(header)));
+
+    rlas_BinaryReader reader(header, headerSize);
+    char magic[sizeof(ImageCacheMagic)] = {};
+    uint32_t version = 0;
+    uint32_t byteOrder = 0;
+    std::string path;
+    uint8_t fromArchive = 0;
+    rlas_FileStamp stamp = { 0, 0 };
+    int32_t width = 0, height = 0, mipmaps = 0, format = 0;
+    uint64_t dataSize = 0;
+
+    reader.ReadBytes(magic, sizeof(magic));
+    reader.Read(version);
+    reader.Read(byteOrder);
+    reader.ReadString(path);
+    reader.Read(fromArchive);
+    ReadStamp(reader, stamp);
+    reader.Read(width);
+    reader.Read(height);
+    reader.Read(mipmaps);
+    reader.Read(format);
+    reader.Read(dataSize);
+
+    bool valid = reader.Ok() && memcmp(magic, ImageCacheMagic, sizeof(magic)) == 0 && version == ImageCacheVersion && byteOrder == ManifestByteOrder
+        && path == meta.RelativeName && fromArchive == (meta.ArchiveFile != nullptr ? 1 : 0) && stamp.Size == source.Size && stamp.ModTime == source.ModTime
+        && dataSize != 0 && dataSize < UINT_MAX && dataSize == GetImageDataSize(width, height, mipmaps, format) && AlignImageData(reader.Position()) + dataSize == fileSize;
+
+    if (valid)
+    {
+        image.data = MemAlloc((unsigned int)dataSize);
+        valid = image.data != nullptr && rlas_ReadFileAt(file, AlignImageData(reader.Position()), image.data, (size_t)dataSize) == dataSize;
+        if (!valid)
+        {
+            MemFree(image.data);
+            image.data = nullptr;
+        }
+    }
+    rlas_CloseReadFile(file);
+
+    if (!valid)
+        return false;
+
+    image.width = width;
+    image.height = height;
+    image.mipmaps = mipmaps;
+    image.format = format;
+    return true;
+}
+
+// written under a unique name first so other processes sharing the cache never see a partial file or write over each other
+bool WriteCachedImage(const std::string& fileName, const rlas_AssetMeta& meta, const rlas_FileStamp& source, const Image& image, uint64_t dataSize)
+{
+    rlas_BinaryWriter writer;
+    WriteImageHeader(writer, meta, source, image, dataSize);
+
+    return ReplaceFileWith(fileName, [&](FILE* file)
+    {
+        return fwrite(writer.Buffer.data(), 1, writer.Buffer.size(), file) == writer.Buffer.size() && fwrite(image.data, 1, (size_t)dataSize, file) == dataSize;
+    });
+}
+
+Image rlas_LoadImage(const char* path)
+{
+    std::string cachePath;
+    {
+        std::lock_guard<std::mutex> lock(ImageCacheLock);
+        cachePath = ImageCachePath;
+    }
+
+    // the source is stamped before decoding, if it changes in between the entry is stale and the next load decodes it again
+    AssetPtr meta = cachePath.empty() ? nullptr : FindAsset(path);
+    rlas_FileStamp source = { 0, 0 };
+    if (meta == nullptr || !GetImageSource(*meta, source))
+        return LoadImage(path);
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.rlimg", (unsigned long long)rlas_HashPath(meta->RelativeName.c_str()));
+    std::string fileName = cachePath + name;
+
+    Image image = {};
+    if (ReadCachedImage(fileName, *meta, source, image))
+    {
+        rlas_AddStat(Stats.ImageCacheHits);
+        return image;
+    }
+
+    rlas_AddStat(Stats.ImageCacheMisses);
+    image = LoadImage(meta->RelativeName.c_str());
+
+    uint64_t dataSize = image.data == nullptr ? 0 : GetImageDataSize(image.width, image.height, image.mipmaps, image.format);
+    if (dataSize != 0 && dataSize < UINT_MAX)
+        WriteCachedImage(fileName, *meta, source, image, dataSize);
+
+    return image;
+}
+
+// the watcher is only read and changed under the mount lock
+int DirectoryWatcher = -1;
+
+// changed assets waiting for the game to take them
+std::mutex ChangeLock;
+std::deque<std::string> ChangedAssets;
+std::set<std::string> QueuedAssets;
+
+void WatchIndexedDirectories()
+{
+    if (DirectoryWatcher < 0)
+        return;
+
+    for (auto& directory : IndexedDirectories)
+    {
+        if (directory.Watch == -1)
+        {
+            int watch = rlas_AddDirectoryWatch(DirectoryWatcher, directory.Path.c_str());
+            directory.Watch = watch < 0 ? -2 : watch;
+        }
+    }
+}
+
+// drops every watch, the directories indexed after this are watched from scratch
+void ResetDirectoryWatcher()
+{
+    for (auto& directory : IndexedDirectories)
+        directory.Watch = -1;
+
+    {
+        std::lock_guard<std::mutex> lock(ChangeLock);
+        ChangedAssets.clear();
+        QueuedAssets.clear();
+    }
+
+    if (DirectoryWatcher < 0)
+        return;
+
+    rlas_CloseDirectoryWatcher(DirectoryWatcher);
+    DirectoryWatcher = rlas_OpenDirectoryWatcher();
+}
+
+bool StartsWith(const std::string& text, const std::string& prefix)
+{
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+// the names of the assets under a relative directory that match a test
+template<class F>
+std::vector<std::string> CollectAssets(const rlas_AssetTable& table, const std::string& relDirectory, F test)
+{
+    std::vector<std::string> names;
+
+    const rlas_DirectoryTree::Node* node = table.Tree.Find(relDirectory.c_str());
+    if (node == nullptr)
+        return names;
+
+    table.Tree.Visit(*node, true, [&](uint32_t item)
+        {
+            if (test(*table.Assets.ItemAt(item)))
+                names.push_back(table.Assets.NameAt(item));
+            return true;
+        });
+
+    return names;
+}
+
+std::string ParentRelPath(const std::string& relPath)
+{
+    size_t slash = relPath.find_last_of('/');
+    return slash == std::string::npos ? std::string() : relPath.substr(0, slash + 1);
+}
+
+// the asset for a path in a tracked archive, nullptr if the archive has no entry for it
+std::shared_ptr<rlas_AssetMeta> FindArchiveAsset(const std::shared_ptr<rlas_ArchiveFile>& archive, const std::string& relPath)
+{
+    std::string name = relPath.substr(archive->RelPath.size());
+    if (archive->IsPack)
+    {
+        std::shared_ptr<rlas_PackFile> pack = archive->OpenPack();
+        int entry = pack == nullptr ? -1 : pack->Find(name.c_str(), name.size());
+        if (entry < 0 || pack->EntryAt((uint32_t)entry).Size == 0)
+            return nullptr;
+
+        return MakePackAsset(archive, *pack, (uint32_t)entry, archive->RelPath, archive->Mount);
+    }
+
+    std::shared_ptr<miniz_cpp::zip_file> zip = archive->Open();
+    if (zip == nullptr || !zip->has_file(name))
+        return nullptr;
+
+    miniz_cpp::zip_info info = zip->getinfo(name);
+    if (info.file_size == 0)
+        return nullptr;
+
+    return MakeZipAsset(archive, info, archive->RelPath, archive->Mount);
+}
+
+// when an asset goes away, the file or archive entry for the same path in the latest earlier resource path takes its place again,
+// the same one a full scan would find
+void RestoreShadowedFile(rlas_AssetTable& table, const std::string& relPath)
+{
+    if (table.Assets.Find(relPath.c_str()) != nullptr)
+        return;
+
+    std::string parent = ParentRelPath(relPath);
+    std::string name = relPath.substr(parent.size());
+
+    std::shared_ptr<rlas_AssetMeta> best;
+    for (auto& directory : IndexedDirectories)
+    {
+        if ((best != nullptr && best->Mount >= directory.Mount) || !rlas_PathEquals(parent.c_str(), parent.size(), directory.RelPath))
+            continue;
+
+        rlas_FileStamp stamp = { 0, 0 };
+        std::string path = directory.Path + name;
+        if (!FileExists(path.c_str()) || !rlas_GetFileStamp(path.c_str(), &stamp))
+            continue;
+
+        best = std::make_shared<rlas_AssetMeta>();
+        best->RelativeName = relPath;
+        best->PathOnDisk = path;
+        best->Mount = directory.Mount;
+        best->Stamp = stamp;
+    }
+
+    for (auto& archive : IndexedArchives)
+    {
+        if ((best != nullptr && best->Mount >= archive->Mount) || !HasPathPrefix(relPath.c_str(), archive->RelPath))
+            continue;
+
+        std::shared_ptr<rlas_AssetMeta> meta = FindArchiveAsset(archive, relPath);
+        if (meta != nullptr)
+            best = meta;
+    }
+
+    if (best != nullptr)
+        SetAsset(table, best->RelativeName, best);
+}
+
+void RemoveAssets(rlas_AssetTable& table, const std::vector<std::string>& names, std::vector<std::string>& changed)
+{
+    for (auto& name : names)
+        RemoveAsset(table, name);
+
+    for (auto& name : names)
+    {
+        RestoreShadowedFile(table, name);
+        changed.push_back(name);
+    }
+}
+
+// drops the lazy sources of a path on disk, or with prefix of everything under it
+void RemoveLazySources(rlas_AssetTable& table, const std::string& path, bool prefix)
+{
+    std::vector<std::string> emptied;
+    for (size_t i = 0; i < table.Lazy.Size(); ++i)
+    {
+        std::vector<rlas_LazySource>& sources = table.Lazy.ItemAt(i)->Sources;
+        sources.erase(std::remove_if(sources.begin(), sources.end(),
+            [&](const rlas_LazySource& source) { return prefix ? StartsWith(source.Path, path) : source.Path == path; }), sources.end());
+
+        if (sources.empty())
+            emptied.push_back(table.Lazy.NameAt(i));
+    }
+
+    for (auto& name : emptied)
+        RemoveLazyDirectory(table, name);
+}
+
+void RemoveArchive(rlas_AssetTable& table, const std::string& archivePath, const std::string& archiveRelPath, std::vector<std::string>& changed)
+{
+    // an archive that was never read only has to be forgotten, a changed one is then read in full by RemountArchive
+    RemoveLazySources(table, archivePath, false);
+
+    for (size_t i = 0; i < IndexedArchives.size(); ++i)
+    {
+        std::shared_ptr<rlas_ArchiveFile> archive = IndexedArchives[i];
+        if (archive->Path != archivePath)
+            continue;
+
+        IndexedArchives.erase(IndexedArchives.begin() + i);
+        RemoveAssets(table, CollectAssets(table, archiveRelPath, [&](const rlas_AssetMeta& meta) { return meta.ArchiveFile == archive; }), changed);
+        return;
+    }
+}
+
+void RemountArchive(rlas_AssetTable& table, const rlas_IndexedDirectory& directory, const std::string& archivePath, const std::string& archiveRelPath, std::vector<std::string>& changed)
+{
+    RemoveArchive(table, archivePath, archiveRelPath, changed);
+
+    try
+    {
+        AddArchiveFile(table, archivePath, archiveRelPath, directory.Mount);
+    }
+    catch (...)
+    {
+        // an archive that can not be read yet is left out, it is added when it is written again
+        return;
+    }
+
+    std::vector<std::string> added = CollectAssets(table, archiveRelPath, [&](const rlas_AssetMeta& meta) { return meta.ArchiveFile != nullptr && meta.ArchiveFile->Path == archivePath; });
+    changed.insert(changed.end(), added.begin(), added.end());
+}
+
+void RemoveDirectory(rlas_AssetTable& table, const std::string& path, const std::string& relPath, std::vector<std::string>& changed)
+{
+    RemoveLazySources(table, path, true);
+
+    for (size_t i = 0; i < IndexedDirectories.size();)
+    {
+        if (!StartsWith(IndexedDirectories[i].Path, path))
+        {
+            ++i;
+            continue;
+        }
+
+        // a directory that was moved away is still watched under its new name
+        if (IndexedDirectories[i].Watch >= 0)
+            rlas_RemoveDirectoryWatch(DirectoryWatcher, IndexedDirectories[i].Watch);
+        IndexedDirectories.erase(IndexedDirectories.begin() + i);
+    }
+
+    IndexedArchives.erase(std::remove_if(IndexedArchives.begin(), IndexedArchives.end(),
+        [&](const std::shared_ptr<rlas_ArchiveFile>& archive) { return StartsWith(archive->Path, path); }), IndexedArchives.end());
+
+    RemoveAssets(table, CollectAssets(table, relPath, [&](const rlas_AssetMeta& meta) { return StartsWith(meta.PathOnDisk, path); }), changed);
+}
+
+void ApplyWatchEvent(rlas_AssetTable& table, const rlas_IndexedDirectory& directory, const rlas_WatchEvent& event, std::vector<std::string>& changed)
+{
+    std::string path = directory.Path + event.Name;
+    std::string relPath = directory.RelPath + event.Name;
+
+    bool isArchive = IsArchiveFile(event.Name);
+    std::string archiveRelPath = isArchive ? ArchiveRelPath(relPath) : std::string();
+
+    switch (event.Type)
+    {
+    case WatchFileChanged:
+        if (isArchive)
+        {
+            RemountArchive(table, directory, path, archiveRelPath, changed);
+        }
+        else
+        {
+            // a changed file gets a new stamp, so its size is served from the index again
+            rlas_FileStamp stamp = { 0, 0 };
+            rlas_GetFileStamp(path.c_str(), &stamp);
+
+            const AssetPtr* current = table.Assets.Find(relPath.c_str());
+            if (current == nullptr || (*current)->ArchiveFile != nullptr || (*current)->PathOnDisk != path
+                || (*current)->Stamp.Size != stamp.Size || (*current)->Stamp.ModTime != stamp.ModTime)
+            {
+                std::shared_ptr<rlas_AssetMeta> meta = std::make_shared<rlas_AssetMeta>();
+                meta->RelativeName = relPath;
+                meta->PathOnDisk = path;
+                meta->Mount = directory.Mount;
+                meta->Stamp = stamp;
+                SetAsset(table, relPath, meta);
+            }
+
+            current = table.Assets.Find(relPath.c_str());
+            if (current != nullptr && (*current)->PathOnDisk == path)
+                changed.push_back(relPath);
+        }
+        break;
+
+    case WatchFileRemoved:
+        if (isArchive)
+        {
+            RemoveArchive(table, path, archiveRelPath, changed);
+        }
+        else
+        {
+            const AssetPtr* current = table.Assets.Find(relPath.c_str());
+            if (current != nullptr && (*current)->ArchiveFile == nullptr && (*current)->PathOnDisk == path)
+                RemoveAssets(table, std::vector<std::string>(1, relPath), changed);
+        }
+        break;
+
+    case WatchDirectoryAdded:
+    {
+        // an archive still being copied in is left out and added when it is written, the rest of the directory is still watched
+        std::string root = path + PathDelim;
+        try
+        {
+            RecurseAddFiles(table, root, relPath + "/", directory.Mount, true, true);
+        }
+        catch (...)
+        {
+            // a directory that can not be read is left out, like an archive in RemountArchive
+            break;
+        }
+
+        std::vector<std::string> added = CollectAssets(table, relPath, [&](const rlas_AssetMeta& meta) { return StartsWith(meta.PathOnDisk, root); });
+        changed.insert(changed.end(), added.begin(), added.end());
+        break;
+    }
+
+    case WatchDirectoryRemoved:
+        RemoveDirectory(table, path + PathDelim, relPath + "/", changed);
+        break;
+
+    default:
+        break;
+    }
+}
+
+// a new file is reported when it is created and again when it is written, so an archive would be read twice in one update
+// a change is dropped when the next event for the same entry is another change, the last one is applied
+void DropRepeatedChanges(std::vector<rlas_WatchEvent>& events)
+{
+    std::map<std::pair<int, std::string>, rlas_WatchEventType> next;
+    std::vector<rlas_WatchEvent> kept;
+    for (size_t i = events.size(); i-- > 0;)
+    {
+        rlas_WatchEvent& event = events[i];
+        auto later = next.find(std::make_pair(event.Watch, event.Name));
+        if (event.Type == WatchFileChanged && later != next.end() && later->second == WatchFileChanged)
+            continue;
+
+        next[std::make_pair(event.Watch, event.Name)] = event.Type;
+        kept.push_back(std::move(event));
+    }
+
+    events.assign(std::make_move_iterator(kept.rbegin()), std::make_move_iterator(kept.rend()));
+}
+
+bool rlas_WatchResourcePaths(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    if (!enabled)
+    {
+        if (DirectoryWatcher >= 0)
+            rlas_CloseDirectoryWatcher(DirectoryWatcher);
+        DirectoryWatcher = -1;
+
+        for (auto& directory : IndexedDirectories)
+            directory.Watch = -1;
+        return true;
+    }
+
+    if (DirectoryWatcher < 0)
+        DirectoryWatcher = rlas_OpenDirectoryWatcher();
+
+    WatchIndexedDirectories();
+    return DirectoryWatcher >= 0;
+}
+
+int rlas_UpdateWatchedResources()
+{
+    std::lock_guard<std::mutex> lock(MountLock);
+
+    std::vector<rlas_WatchEvent> events;
+    if (DirectoryWatcher < 0 || !rlas_ReadDirectoryWatcher(DirectoryWatcher, events) || events.empty())
+        return 0;
+
+    DropRepeatedChanges(events);
+
+    std::shared_ptr<rlas_AssetTable> table = CopyAssetTable();
+    std::vector<std::string> changed;
+    bool overflow = false;
+
+    for (auto& event : events)
+    {
+        if (event.Type == WatchOverflow)
+        {
+            overflow = true;
+            continue;
+        }
+
+        // copied, applying an event can add and remove indexed directories
+        std::vector<rlas_IndexedDirectory> directories;
+        for (auto& directory : IndexedDirectories)
+        {
+            if (directory.Watch == event.Watch)
+                directories.push_back(directory);
+        }
+
+        for (auto& directory : directories)
+        {
+            // a watched directory that is gone takes its assets with it, the parent directory may not be watched
+            if (event.Type == WatchRemoved)
+            {
+                rlas_FileStamp stamp;
+                if (!rlas_GetFileStamp(directory.Path.c_str(), &stamp))
+                    RemoveDirectory(*table, directory.Path, directory.RelPath, changed);
+                continue;
+            }
+
+            ApplyWatchEvent(*table, directory, event, changed);
+        }
+    }
+
+    PublishAssetTable(table);
+    WatchIndexedDirectories();
+
+    int count = 0;
+    {
+        std::lock_guard<std::mutex> changeLock(ChangeLock);
+        for (auto& name : changed)
+        {
+            if (QueuedAssets.insert(name).second)
+            {
+                ChangedAssets.push_back(name);
+                ++count;
+            }
+        }
+    }
+
+    return overflow ? -1 : count;
+}
+
+int rlas_TakeChangedAsset(char* destination, int length)
+{
+    std::lock_guard<std::mutex> lock(ChangeLock);
+
+    if (ChangedAssets.empty())
+        return 0;
+
+    const std::string& name = ChangedAssets.front();
+    if (destination == nullptr || (int)name.size() > length - 1)
+        return -1;
+
+    memcpy(destination, name.c_str(), name.size());
+    destination[name.size()] = '\0';
+
+    int size = (int)name.size();
+    QueuedAssets.erase(name);
+    ChangedAssets.pop_front();
+    return size;
+}
@@ -33,6 +33,108 @@
 
 #include "raylib.h"
 
+/// <summary>
+/// A read only view of the contents of an asset
+/// </summary>
+typedef struct rlas_AssetView
+{
+    const unsigned char* data;  // the asset data, NULL if the asset could not be loaded
+    unsigned int size;          // the size of the data in bytes
+    bool mapped;                // true when data points directly into an archive, false when it is a copy
+    void* owner;                // internal, what keeps the data valid
+} rlas_AssetView;
+
+/// <summary>
+/// A virtual path interned by rlas_ResolveHandle, 0 is never a valid handle
+/// </summary>
+typedef unsigned int rlas_AssetHandle;
+
+/// <summary>
+/// A directory or archive mounted with rlas_Mount, 0 is never a valid mount
+/// </summary>
+typedef unsigned int rlas_MountId;
+
+/// <summary>
+/// A handle to an asset being loaded on a worker thread
+/// </summary>
+typedef struct rlas_AsyncLoad rlas_AsyncLoad;
+
+/// <summary>
+/// A handle to an asset being read in pieces
+/// </summary>
+typedef struct rlas_AssetStream rlas_AssetStream;
+
+/// <summary>
+/// The state of a prefetch started with rlas_PrefetchGroup
+/// </summary>
+typedef struct rlas_PrefetchProgress
+{
+    int assets;                 // the number of assets in the prefetch
+    int assetsDone;             // the number of assets that have been read
+    unsigned long long bytes;   // the number of bytes that have been read
+    bool finished;              // true when no more work will be done, either all assets were read or the prefetch was cancelled
+    bool cancelled;             // true if the prefetch was cancelled before every asset was read
+} rlas_PrefetchProgress;
+
+/// <summary>
+/// Totals of the work done by rlAssets while stats were enabled, since startup or the last rlas_ResetStats
+/// </summary>
+typedef struct rlas_Stats
+{
+    unsigned long long lookups;             // virtual paths looked up
+    unsigned long long lookupHits;          // lookups that found an asset
+    unsigned long long lookupMisses;        // lookups that did not find an asset
+    unsigned long long loads;               // assets loaded, read, viewed or streamed
+    unsigned long long bytesFromDisk;       // bytes loaded from files in resource paths
+    unsigned long long bytesFromArchives;   // bytes loaded from zips and packs
+    unsigned long long fileOpens;           // files and archives opened
+    double fileOpenSeconds;                 // time spent opening files and archives
+    unsigned long long inflates;            // decompressions of entries, pack blocks or stream reads
+    unsigned long long inflatedBytes;       // bytes decompressed
+    double inflateSeconds;                  // time spent decompressing
+    unsigned long long tempExtractions;     // archive assets written out for rlas_GetAssetPath
+    unsigned long long tempExtractionBytes; // bytes written out for rlas_GetAssetPath
+    unsigned long long imageCacheHits;      // images from rlas_LoadImage read from the decoded image cache
+    unsigned long long imageCacheMisses;    // images from rlas_LoadImage that had to be decoded
+} rlas_Stats;
+
+/// <summary>
+/// Counters for one asset
+/// </summary>
+typedef struct rlas_AssetStats
+{
+    unsigned long long lookups;     // times the asset was looked up
+    unsigned long long loads;       // times the asset was loaded, read, viewed or streamed
+    unsigned long long bytes;       // bytes of the asset that were loaded
+    double loadSeconds;             // time spent loading the asset
+} rlas_AssetStats;
+
+/// <summary>
+/// How rlas_GetAssetPath gives a path on disk to assets that are in archives
+/// </summary>
+typedef enum rlas_ExtractionMode
+{
+    RLAS_EXTRACT_TEMP_FILES = 0,    // written to the temp path and deleted during cleanup (the default)
+    RLAS_EXTRACT_MEMORY_FILES,      // kept in memory files with /proc/self/fd/N paths, only valid in this process (Linux only)
+    RLAS_EXTRACT_CACHED_FILES,      // written to the temp path under a name with the archive and the entry's crc and size, kept after cleanup and reused by later runs
+} rlas_ExtractionMode;
+
+/// <summary>
+/// Counters for the decompressed archive data cache
+/// </summary>
+typedef struct rlas_ArchiveCacheStats
+{
+    unsigned long long hits;        // loads served from the cache
+    unsigned long long misses;      // loads that had to decompress the entry
+    unsigned long long evictions;   // entries removed to stay in the budget
+    unsigned long long bytesUsed;   // bytes of data currently cached
+    unsigned long long budget;      // the maximum bytes of data to cache
+    unsigned int entries;           // number of entries currently cached
+} rlas_ArchiveCacheStats;
+
+// Assets can be looked up and loaded from any thread, including while another thread adds resource paths or archives.
+// Lookups read the asset table that was current when they started, new resources show up once they are fully added.
+
 /// <summary>
 /// Gets the application (exe) directory for the currently running program
 /// </summary>
@@ -67,6 +169,15 @@ void rlas_Cleanup();
 /// <param name="path">The absolute path to use in OS format</param>
 void rlas_SetTempPath(const char* path);
 
+/// <summary>
+/// Sets how assets in archives are extracted when their path is requested
+/// Paths that were already returned stay valid until cleanup
+/// RLAS_EXTRACT_CACHED_FILES works best with a temp path on a memory backed file system such as /dev/shm
+/// </summary>
+/// <param name="mode">The extraction mode to use</param>
+/// <returns>False if the mode is not supported on this OS, the current mode is kept</returns>
+bool rlas_SetExtractionMode(rlas_ExtractionMode mode);
+
 /// <summary>
 /// Returns the top level asset root path
 /// </summary>
@@ -82,19 +193,61 @@ const char* rlas_GetAssetRootPath();
 void rlas_AddAssetResourcePath(const char* path);
 
 /// <summary>
-/// Adds zip file as if it was an extracted resource path
-/// All files in the zip will be added to the root of the virtual path
+/// Adds zip file or rlAssets pack (.rlpak) as if it was an extracted resource path
+/// All files in the archive will be added to the root of the virtual path
+/// Archives found in resource paths are added as a directory with the archive's name without the extension
 /// Any files that are duplicated in resource paths will be 'merged' into the virtual file structure and override older paths
 /// </summary>
 /// <param name="path">The path of the archive to add</param>
 /// <param name="relativeToApp">When true the specified path will be used relative to the application root and should be in unix (/) format, when false the path specified is in the OSs format</param>
 void rlas_AddAssetResourceArchive(const char* path, bool relativeToApp);
 
+/// <summary>
+/// Mounts a directory or archive (zip or pack) at a virtual path prefix, "textures/mymod" puts "a.png" in the source at "textures/mymod/a.png"
+/// Nothing is read until a lookup or listing reaches the prefix, then the whole source is indexed once, so mounting and unmounting are cheap
+/// An asset in a mount with a higher priority overrides the same path in any lower one, at the same priority the later mount wins
+/// Resource paths and archives added with the other calls have priority 0, mounts are not saved in the asset manifest or watched for changes
+/// A patch can delete files with a "rlas_tombstones.txt" at the root of the source, each line a path relative to the source that is hidden
+/// in every layer below this mount, a line ending in '/' hides a whole directory and '#' starts a comment
+/// </summary>
+/// <param name="source">The directory or archive to mount in the OSs format</param>
+/// <param name="virtualPrefix">The virtual directory to mount it at, NULL or "" for the root</param>
+/// <param name="priority">The override priority</param>
+/// <returns>The mount, 0 if the source is empty</returns>
+rlas_MountId rlas_Mount(const char* source, const char* virtualPrefix, int priority);
+
+/// <summary>
+/// Removes a mount, the assets of lower mounts that it overrode or hid are found again
+/// Only the mount list changes, the asset index and the other mounts are not copied
+/// </summary>
+/// <param name="mount">A mount from rlas_Mount</param>
+/// <returns>False if the mount was not found</returns>
+bool rlas_Unmount(rlas_MountId mount);
+
+/// <summary>
+/// Sets how archives added after this call are read
+/// When enabled (the default) archives are memory mapped, only the central directory is read when the archive is added and file data is paged in as it is used
+/// When disabled, or if the archive can not be mapped, the entire archive is read into memory
+/// Archive files must not be modified on disk while they are mapped
+/// </summary>
+/// <param name="enabled">Use memory mapping for archives</param>
+void rlas_SetArchiveMemoryMapping(bool enabled);
+
+/// <summary>
+/// Sets how resource paths added after this call are indexed (by rlas_SetAssetRootPath and rlas_AddAssetResourcePath)
+/// When enabled only the top directory is listed when the path is added, sub directories and archives are indexed the first time a lookup or listing reaches them
+/// Override order between resource paths is the same as when everything is indexed up front
+/// Disabled by default
+/// </summary>
+/// <param name="enabled">Index directories and archives on demand</param>
+void rlas_SetLazyIndexing(bool enabled);
+
 /// <summary>
 /// Gets the path on disk for an assets relative path
 /// If multiple resource paths exist with the asset, the one added last will be returned.
-/// If the asset is in an archive, and a temp directory is set, the asset will be extracted to the temp folder and that path will be returned
-/// Temp files are deleted during cleanup
+/// If the asset is in an archive it is extracted as set by rlas_SetExtractionMode and that path will be returned
+/// Extracting to files needs a temp directory, memory files do not
+/// Temp files are deleted during cleanup, cached files are not
 /// </summary>
 /// <param name="path">The relative path of the asset to look up</param>
 /// <returns>The path on disk of the asset</returns>
@@ -105,25 +258,418 @@ const char* rlas_GetAssetPath(const char* path);
 /// Call once with results as NULL to get the count to allocate a result buffer large enough
 /// Then call again with buffer to get results.
 /// </summary>
-/// <param name="path">The relative path to search </param>
+/// <param name="path">The relative directory to search, "" or "/" for the root</param>
 /// <param name="includeSubDirectories">Search into subdirectories</param>
 /// <param name="results">A pointer to a character array to store the results, when null not used.</param>
 /// <returns>The number of asset items found</returns>
 int rlas_GetAssetsInPath(const char* path, bool includeSubDirectories, char** results);
 
 /// <summary>
-/// Returns true if the asset is part of an archive (zip) file
+/// Lists the relative asset names in a resource path in a single call
+/// The directory structure is indexed when assets are added, so the cost only depends on the number of results
+/// </summary>
+/// <param name="path">The relative directory to search, "" or "/" for the root, a trailing '/' is optional</param>
+/// <param name="includeSubDirectories">Search into subdirectories</param>
+/// <param name="results">Caller provided storage for the names, may be NULL to only count. The names are owned by rlAssets and valid until the asset is replaced by a later resource or the next cleanup.</param>
+/// <param name="maxResults">The number of names results can hold</param>
+/// <returns>The total number of assets found, which may be more than maxResults</returns>
+int rlas_ListAssetsInPath(const char* path, bool includeSubDirectories, const char** results, int maxResults);
+
+/// <summary>
+/// Returns true if the asset is part of an archive (zip or pack) file
 /// </summary>
 /// <param name="path">The relative virtual path to the asset</param>
 /// <returns>True if the asset is contained in an archive.</returns>
 bool rlas_FileIsArchive(const char* path);
 
+/// <summary>
+/// Interns a virtual path and returns a handle for it, the same path (ignoring case) always gives the same handle
+/// Handles stay valid for the life of the program, through remounts and cleanups, the asset does not need to exist yet
+/// After the first use following a mount, the handle functions find the asset without any string work
+/// Lookups by path are not cached, each one probes the asset map and every mount that could override it, use handles for assets looked up every frame
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <returns>The handle, 0 if the path is empty</returns>
+rlas_AssetHandle rlas_ResolveHandle(const char* path);
+
+/// <summary>
+/// Gets the path a handle was resolved from
+/// </summary>
+/// <param name="handle">A handle from rlas_ResolveHandle</param>
+/// <returns>The path as it was first resolved, NULL for an invalid handle</returns>
+const char* rlas_GetHandlePath(rlas_AssetHandle handle);
+
+/// <summary>
+/// Gets the file size of an asset by handle, see rlas_GetFileSize
+/// </summary>
+/// <param name="handle">A handle from rlas_ResolveHandle</param>
+/// <returns>The file size in bytes, 0 if the asset does not exist</returns>
+unsigned int rlas_GetFileSizeByHandle(rlas_AssetHandle handle);
+
+/// <summary>
+/// Returns true if the asset of a handle is part of an archive (zip or pack) file
+/// </summary>
+/// <param name="handle">A handle from rlas_ResolveHandle</param>
+/// <returns>True if the asset is contained in an archive.</returns>
+bool rlas_FileIsArchiveByHandle(rlas_AssetHandle handle);
+
+/// <summary>
+/// Loads the data of an asset by handle, like LoadFileData
+/// The data must be freed with MemFree (or UnloadFileData)
+/// </summary>
+/// <param name="handle">A handle from rlas_ResolveHandle</param>
+/// <param name="bytesRead">The size of the data in bytes</param>
+/// <returns>The loaded data, NULL if the asset does not exist or could not be loaded</returns>
+unsigned char* rlas_LoadAssetByHandle(rlas_AssetHandle handle, unsigned int* bytesRead);
+
+/// <summary>
+/// Loads the text of an asset by handle, like LoadFileText
+/// The text must be freed with MemFree (or UnloadFileText)
+/// </summary>
+/// <param name="handle">A handle from rlas_ResolveHandle</param>
+/// <returns>The NUL terminated text, NULL if the asset does not exist or could not be loaded</returns>
+char* rlas_LoadAssetTextByHandle(rlas_AssetHandle handle);
+
 /// <summary>
 /// Gets the file size of an asset from any source
+/// The size comes from the index, for files it is the size when the file was indexed (or last seen changed by the watcher)
 /// </summary>
 /// <param name="path">The relative virtual path to the asset</param>
 /// <returns>The file size in bytes</returns>
 unsigned int rlas_GetFileSize(const char* path);
 
-#endif //RLASSETS_H
+/// <summary>
+/// Loads a whole asset into a caller provided buffer, the data is read (or decompressed) straight into the buffer
+/// Use rlas_GetFileSize to find the size of buffer needed
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <param name="buffer">The destination</param>
+/// <param name="bufferSize">The size of the destination in bytes</param>
+/// <returns>The size of the asset in bytes, 0 if it could not be loaded or does not fit in the buffer</returns>
+unsigned int rlas_LoadAssetInto(const char* path, void* buffer, unsigned int bufferSize);
+
+/// <summary>
+/// Loads a whole text asset into a caller provided buffer and null terminates it, the buffer needs one byte more than the asset size
+/// The text is the same LoadFileText gives, on Windows the line endings of loose files are folded to \n so the size can be less than the asset size
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <param name="buffer">The destination</param>
+/// <param name="bufferSize">The size of the destination in bytes</param>
+/// <returns>The size of the text in bytes (not including the terminator), 0 if it could not be loaded or does not fit in the buffer</returns>
+unsigned int rlas_LoadAssetTextInto(const char* path, char* buffer, unsigned int bufferSize);
+
+/// <summary>
+/// Loads an asset into a buffer from the transient buffer pool, for data that is only needed for a short time (such as while decoding it)
+/// The data is followed by a null terminator so text can be used directly
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <param name="bytesRead">The size of the asset in bytes (not including the terminator)</param>
+/// <returns>The data, must be returned with rlas_ReleaseTransient, NULL if the asset could not be loaded</returns>
+unsigned char* rlas_LoadTransient(const char* path, unsigned int* bytesRead);
+
+/// <summary>
+/// Returns a buffer from rlas_LoadTransient to the pool
+/// </summary>
+/// <param name="data">The data to release</param>
+void rlas_ReleaseTransient(unsigned char* data);
+
+/// <summary>
+/// Sets how many bytes of released transient buffers are kept for reuse
+/// Buffers are pooled in power of two sizes from 4 KB to 64 MB, larger buffers are always freed
+/// </summary>
+/// <param name="bytes">The maximum bytes to keep, 0 frees released buffers right away (the default)</param>
+void rlas_SetTransientPoolBudget(unsigned long long bytes);
+
+/// <summary>
+/// Reads part of an asset into a caller provided buffer
+/// Assets in packs only decompress the blocks the range touches, files on disk and stored zip entries only read the range,
+/// compressed zip entries are inflated from the start (and use the archive cache when it is enabled)
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <param name="offset">The first byte of the asset to read</param>
+/// <param name="buffer">The destination, at least size bytes</param>
+/// <param name="size">The number of bytes to read</param>
+/// <returns>The number of bytes read, less than size when the range goes past the end of the asset</returns>
+unsigned int rlas_ReadAssetRange(const char* path, unsigned long long offset, void* buffer, unsigned int size);
+
+/// <summary>
+/// Gets a read only view of the contents of an asset
+/// Assets stored in an archive without compression are not copied, the view points directly into the archive
+/// Compressed assets and files on disk are loaded into a copy
+/// Every view must be released with rlas_ReleaseAssetView
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <param name="view">The view to fill out</param>
+/// <returns>True if the asset was found and loaded</returns>
+bool rlas_GetAssetView(const char* path, rlas_AssetView* view);
+
+/// <summary>
+/// Releases the data of a view returned by rlas_GetAssetView
+/// </summary>
+/// <param name="view">The view to release</param>
+void rlas_ReleaseAssetView(rlas_AssetView* view);
+
+/// <summary>
+/// Opens an asset to be read in pieces, for assets too large to load at once such as music and video
+/// Memory use is fixed no matter the size of the asset, compressed zip entries are inflated as they are read
+/// A stream must only be used by one thread at a time
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <returns>The stream, NULL if the asset was not found or could not be opened</returns>
+rlas_AssetStream* rlas_OpenStream(const char* path);
+
+/// <summary>
+/// Reads the next bytes of a stream
+/// </summary>
+/// <param name="stream">The stream to read</param>
+/// <param name="buffer">The destination, at least size bytes</param>
+/// <param name="size">The number of bytes to read</param>
+/// <returns>The number of bytes read, less than size at the end of the asset or on a read error</returns>
+unsigned int rlas_ReadStream(rlas_AssetStream* stream, void* buffer, unsigned int size);
+
+/// <summary>
+/// Moves the read position of a stream
+/// Seeking backwards in a compressed zip entry inflates the entry again from the start, packs and stored entries seek freely
+/// </summary>
+/// <param name="stream">The stream to seek</param>
+/// <param name="offset">The offset from the origin in bytes</param>
+/// <param name="origin">SEEK_SET, SEEK_CUR or SEEK_END</param>
+/// <returns>False if the position would be outside the asset or the data could not be read</returns>
+bool rlas_SeekStream(rlas_AssetStream* stream, long long offset, int origin);
+
+/// <summary>
+/// Gets the read position of a stream
+/// </summary>
+unsigned long long rlas_GetStreamPosition(rlas_AssetStream* stream);
+
+/// <summary>
+/// Gets the total size of the asset being streamed
+/// </summary>
+unsigned long long rlas_GetStreamSize(rlas_AssetStream* stream);
+
+/// <summary>
+/// Closes a stream opened with rlas_OpenStream
+/// </summary>
+void rlas_CloseStream(rlas_AssetStream* stream);
+
+/// <summary>
+/// Starts loading the contents of an asset on a worker thread
+/// Files on disk and assets in archives are both read (and decompressed) by the worker
+/// The asset is looked up when this is called, so resource paths added or cleaned up while the load is in progress do not change what is loaded
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <returns>A handle to the load, must be released with rlas_ReleaseAsyncLoad</returns>
+rlas_AsyncLoad* rlas_LoadAsync(const char* path);
+
+/// <summary>
+/// Starts loading the contents of a text asset on a worker thread, the data will be null terminated
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <returns>A handle to the load, must be released with rlas_ReleaseAsyncLoad</returns>
+rlas_AsyncLoad* rlas_LoadTextAsync(const char* path);
+
+/// <summary>
+/// Checks if an asynchronous load has finished, does not block
+/// </summary>
+/// <param name="load">The load to check</param>
+/// <returns>True when the data is ready to be taken</returns>
+bool rlas_IsAsyncLoadDone(rlas_AsyncLoad* load);
+
+/// <summary>
+/// Blocks until an asynchronous load has finished
+/// </summary>
+/// <param name="load">The load to wait for</param>
+void rlas_WaitAsyncLoad(rlas_AsyncLoad* load);
 
+/// <summary>
+/// Takes ownership of the data from a load, waiting for it to finish if needed
+/// The data must be freed with MemFree (or UnloadFileData/UnloadFileText) and is only returned once
+/// </summary>
+/// <param name="load">The load to take the data from</param>
+/// <param name="bytesRead">The size of the data in bytes (not including the terminator for text)</param>
+/// <returns>The loaded data, NULL if the asset could not be loaded</returns>
+unsigned char* rlas_TakeAsyncLoadData(rlas_AsyncLoad* load, unsigned int* bytesRead);
+
+/// <summary>
+/// Releases a load handle, data that was not taken is freed
+/// Releasing a load that has not finished does not block, the load is skipped if it has not started
+/// </summary>
+/// <param name="load">The load to release</param>
+void rlas_ReleaseAsyncLoad(rlas_AsyncLoad* load);
+
+/// <summary>
+/// Loads the contents of many assets at once, spread over the worker threads and the calling thread, and waits for all of them
+/// Assets in the same archive are decompressed at the same time by different threads
+/// </summary>
+/// <param name="paths">The relative virtual paths of the assets</param>
+/// <param name="count">The number of paths</param>
+/// <param name="data">An array of count pointers, each is set to the data of the asset or NULL if it could not be loaded, each must be freed with MemFree (or UnloadFileData)</param>
+/// <param name="sizes">An array of count sizes, each is set to the size of the asset in bytes</param>
+/// <returns>The number of assets that were loaded</returns>
+int rlas_LoadBatch(const char** paths, int count, unsigned char** data, unsigned int* sizes);
+
+/// <summary>
+/// Sets the number of worker threads used for asynchronous loads, batch loads and prefetching
+/// </summary>
+/// <param name="count">The thread count, 0 uses one less than the number of cores</param>
+void rlas_SetAsyncLoadThreads(int count);
+
+/// <summary>
+/// Sets the memory budget for caching decompressed archive entries
+/// When set, compressed assets loaded from archives are kept in memory and repeated loads are copied from the cache instead of being decompressed again
+/// The least recently used entries are removed when the budget is exceeded. Stored (uncompressed) entries are never cached.
+/// </summary>
+/// <param name="bytes">The maximum number of bytes to cache, 0 disables the cache (the default)</param>
+void rlas_SetArchiveCacheBudget(unsigned long long bytes);
+
+/// <summary>
+/// Removes all entries from the decompressed archive cache, this is also done by rlas_Cleanup
+/// </summary>
+void rlas_ClearArchiveCache();
+
+/// <summary>
+/// Gets the counters and memory use of the decompressed archive cache
+/// </summary>
+/// <returns>The current cache statistics</returns>
+rlas_ArchiveCacheStats rlas_GetArchiveCacheStats();
+
+/// <summary>
+/// Turns the counters read by rlas_GetStats, rlas_GetAssetStats and rlas_SaveStats on or off
+/// While on every lookup and load adds to counters shared by all threads, while off they are left as they are and cost one flag check
+/// Disabled by default
+/// </summary>
+/// <param name="enabled">Keep the counters</param>
+void rlas_SetStatsEnabled(bool enabled);
+
+/// <summary>
+/// Gets the totals of lookups, loads, file opens, decompression and extractions since stats were enabled
+/// </summary>
+/// <returns>The current totals</returns>
+rlas_Stats rlas_GetStats();
+
+/// <summary>
+/// Gets the counters for one asset, counters start over when an asset is replaced by a mount or a file change
+/// </summary>
+/// <param name="path">The relative virtual path to the asset</param>
+/// <param name="stats">Filled with the counters of the asset</param>
+/// <returns>False if the asset does not exist</returns>
+bool rlas_GetAssetStats(const char* path, rlas_AssetStats* stats);
+
+/// <summary>
+/// Sets the totals and the counters of every asset back to zero
+/// </summary>
+void rlas_ResetStats();
+
+/// <summary>
+/// Writes the totals and the counters of every asset that was used to a file
+/// </summary>
+/// <param name="fileName">The file to write, CSV if the name ends in .csv, JSON otherwise</param>
+/// <returns>False if the file could not be written</returns>
+bool rlas_SaveStats(const char* fileName);
+
+/// <summary>
+/// Adds assets to a named prefetch group, the group is created if it does not exist
+/// Patterns are matched against relative virtual paths when the group is prefetched, ignoring case
+/// '*' matches any characters in one folder or file name, '**' matches any characters including folders and '?' matches one character
+/// </summary>
+/// <param name="group">The name of the group</param>
+/// <param name="pattern">A relative virtual path or a pattern such as "levels/forest/**"</param>
+void rlas_AddPrefetchGroupPath(const char* group, const char* pattern);
+
+/// <summary>
+/// Removes a prefetch group, a prefetch of the group that is in progress is cancelled
+/// </summary>
+/// <param name="group">The name of the group</param>
+void rlas_RemovePrefetchGroup(const char* group);
+
+/// <summary>
+/// Starts reading every asset in a prefetch group on the worker threads so later loads do not wait on the disk
+/// Files are read to warm the OS file cache, compressed zip entries are decompressed into the archive cache when a cache budget is set
+/// Assets in the same archive are read in the order they are stored in the archive
+/// Prefetching a group that is already being prefetched cancels the earlier prefetch and starts again
+/// </summary>
+/// <param name="group">The name of the group</param>
+/// <returns>False if the group does not exist</returns>
+bool rlas_PrefetchGroup(const char* group);
+
+/// <summary>
+/// Gets the progress of the last prefetch of a group, does not block
+/// </summary>
+/// <param name="group">The name of the group</param>
+/// <param name="progress">Filled with the progress of the prefetch</param>
+/// <returns>False if the group has not been prefetched</returns>
+bool rlas_GetPrefetchProgress(const char* group, rlas_PrefetchProgress* progress);
+
+/// <summary>
+/// Stops a prefetch, assets that are being read are finished and the rest are skipped
+/// </summary>
+/// <param name="group">The name of the group</param>
+void rlas_CancelPrefetch(const char* group);
+
+/// <summary>
+/// Sets a manifest file used to skip scanning the asset root path
+/// When set, rlas_SetAssetRootPath will load the manifest if it was made for the same root path and nothing on disk has changed since it was saved
+/// Otherwise the root path is scanned as normal and a new manifest is saved
+/// </summary>
+/// <param name="fileName">The manifest file path in OS format, NULL to stop using a manifest</param>
+void rlas_SetAssetManifestPath(const char* fileName);
+
+/// <summary>
+/// Saves the current virtual file table to a binary manifest
+/// The manifest stores every asset's relative name and source (file or archive entry), and the size and modification time of every directory and archive that was indexed
+/// </summary>
+/// <param name="fileName">The manifest file path in OS format</param>
+/// <returns>True if the manifest was written</returns>
+bool rlas_SaveAssetManifest(const char* fileName);
+
+/// <summary>
+/// Replaces the virtual file table with the contents of a manifest saved by rlas_SaveAssetManifest
+/// The manifest is only used if every directory and archive it lists is unchanged on disk
+/// Only the stamps of directories are checked, a file edited in place does not invalidate the manifest, so the sizes of loose files are read from disk
+/// Archives are not opened until an asset is read from them
+/// </summary>
+/// <param name="fileName">The manifest file path in OS format</param>
+/// <returns>True if the manifest was valid and loaded, false if it was missing or out of date (the table is not changed)</returns>
+bool rlas_LoadAssetManifest(const char* fileName);
+
+/// <summary>
+/// Sets a directory where rlas_LoadImage keeps decoded pixels, so images loaded by an earlier run skip the decoder
+/// Each image is one file with its virtual path, the size and modification time (or archive crc) of the source, the format, the mip levels and the raw pixels
+/// An entry is only used while its source is unchanged, a changed image is decoded again and its entry replaced
+/// </summary>
+/// <param name="path">The directory in OS format, it is created if needed, NULL or "" turns the cache off</param>
+void rlas_SetImageCachePath(const char* path);
+
+/// <summary>
+/// Loads an image through the decoded image cache, the same as LoadImage when the cache is off or the asset is not found
+/// </summary>
+/// <param name="path">The virtual path of the image</param>
+/// <returns>The image, unload it with UnloadImage</returns>
+Image rlas_LoadImage(const char* path);
+
+/// <summary>
+/// Starts or stops watching the directories of the resource paths for changes (Linux only)
+/// Directories added later are watched as they are added
+/// </summary>
+/// <param name="enabled">True to watch, false to stop</param>
+/// <returns>True if watching is active (or was stopped), false if it is not supported on this OS</returns>
+bool rlas_WatchResourcePaths(bool enabled);
+
+/// <summary>
+/// Applies the file changes seen since the last call to the virtual file table, call once per frame while watching
+/// Added, changed and removed files, directories and archives update only the assets they contain, a changed archive is read again
+/// Each asset that changed is added to the changed asset queue
+/// </summary>
+/// <returns>The number of assets added to the queue, -1 if the OS dropped events and the resource paths should be added again</returns>
+int rlas_UpdateWatchedResources();
+
+/// <summary>
+/// Takes the next relative asset name from the changed asset queue
+/// The asset may have been removed, check with rlas_GetAssetPath before reloading it
+/// </summary>
+/// <param name="destination">the destination string</param>
+/// <param name="length">the length of the destination string</param>
+/// <returns>the length of the name, 0 if the queue is empty, -1 if the destination was not long enough (the name stays in the queue)</returns>
+int rlas_TakeChangedAsset(char* destination, int length);
+
+#endif //RLASSETS_H
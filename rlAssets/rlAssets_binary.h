@@ -0,0 +1,122 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAssets * Simple Asset Managment System for Raylib
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+#ifndef RLASSETS_BINARY_H
+#define RLASSETS_BINARY_H
+
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdint.h>
+
+// Helpers for the binary files rlAssets writes for itself (manifests and caches)
+// Values are stored in the byte order of the machine that wrote them, files start with a marker so a reader on a different machine rejects them
+
+/// <summary>
+/// Builds a binary file in memory
+/// </summary>
+class rlas_BinaryWriter
+{
+public:
+    std::vector<unsigned char> Buffer;
+
+    template<class T>
+    void Write(const T& value)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        Buffer.insert(Buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    void WriteBytes(const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        Buffer.insert(Buffer.end(), bytes, bytes + size);
+    }
+
+    void WriteString(const std::string& value)
+    {
+        Write(static_cast<uint32_t>(value.size()));
+        WriteBytes(value.data(), value.size());
+    }
+};
+
+/// <summary>
+/// Reads values from a binary file in memory, every read is bounds checked
+/// Once a read fails all further reads fail, so a sequence of reads can be checked once at the end
+/// </summary>
+class rlas_BinaryReader
+{
+public:
+    rlas_BinaryReader(const void* data, size_t size) : Data(static_cast<const unsigned char*>(data)), Size(size) {}
+
+    bool Ok() const { return Valid; }
+    size_t Position() const { return Offset; }
+
+    template<class T>
+    bool Read(T& value)
+    {
+        return ReadBytes(&value, sizeof(T));
+    }
+
+    bool ReadBytes(void* data, size_t size)
+    {
+        if (!Valid || size > Size - Offset)
+        {
+            Valid = false;
+            return false;
+        }
+
+        memcpy(data, Data + Offset, size);
+        Offset += size;
+        return true;
+    }
+
+    bool ReadString(std::string& value)
+    {
+        uint32_t size = 0;
+        if (!Read(size) || size > Size - Offset)
+        {
+            Valid = false;
+            return false;
+        }
+
+        value.assign(reinterpret_cast<const char*>(Data + Offset), size);
+        Offset += size;
+        return true;
+    }
+
+private:
+    const unsigned char* Data;
+    size_t Size;
+    size_t Offset = 0;
+    bool Valid = true;
+};
+
+#endif //RLASSETS_BINARY_H
@@ -0,0 +1,197 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAssets * Simple Asset Managment System for Raylib
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+#ifndef RLASSETS_CACHE_H
+#define RLASSETS_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+/// <summary>
+/// Least recently used cache of decompressed asset data limited to a byte budget
+/// Items are keyed by the object that owns the data (an archive) and the location of the item in it
+/// A weak reference to the owner is kept so an item is never returned for a source that has been destroyed and had its address reused
+/// Safe to use from multiple threads
+/// </summary>
+class rlas_DataCache
+{
+public:
+    typedef std::shared_ptr<const std::vector<unsigned char>> Data;
+
+    struct Stats
+    {
+        uint64_t Hits = 0;
+        uint64_t Misses = 0;
+        uint64_t Evictions = 0;
+        uint64_t BytesUsed = 0;
+        uint64_t Budget = 0;
+        uint32_t Items = 0;
+    };
+
+    void SetBudget(uint64_t bytes)
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        Budget = bytes;
+        Trim();
+    }
+
+    bool Enabled()
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        return Budget > 0;
+    }
+
+    void Clear()
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        Order.clear();
+        Items.clear();
+        BytesUsed = 0;
+    }
+
+    /// <summary>
+    /// Finds an item and marks it as most recently used, counts a hit or a miss
+    /// </summary>
+    Data Find(const std::shared_ptr<void>& source, uint64_t offset)
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        if (Budget == 0)
+            return nullptr;
+
+        auto itr = Items.find(Key{ source.get(), offset });
+        if (itr == Items.end() || itr->second->Source.expired())
+        {
+            ++Misses;
+            return nullptr;
+        }
+
+        Order.splice(Order.begin(), Order, itr->second);
+        ++Hits;
+        return itr->second->Bytes;
+    }
+
+    /// <summary>
+    /// Adds an item, evicting the least recently used items until it fits in the budget
+    /// Items larger than the budget are not stored
+    /// </summary>
+    void Add(const std::shared_ptr<void>& source, uint64_t offset, const Data& bytes)
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        if (bytes == nullptr || bytes->size() > Budget)
+            return;
+
+        Key key{ source.get(), offset };
+        auto itr = Items.find(key);
+        if (itr != Items.end())
+            Remove(itr->second);
+
+        Order.push_front(Entry{ key, source, bytes });
+        Items[key] = Order.begin();
+        BytesUsed += bytes->size();
+
+        Trim();
+    }
+
+    Stats GetStats()
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        Stats stats;
+        stats.Hits = Hits;
+        stats.Misses = Misses;
+        stats.Evictions = Evictions;
+        stats.BytesUsed = BytesUsed;
+        stats.Budget = Budget;
+        stats.Items = static_cast<uint32_t>(Items.size());
+        return stats;
+    }
+
+    void ResetStats()
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        Hits = Misses = Evictions = 0;
+    }
+
+private:
+    struct Key
+    {
+        const void* Source;
+        uint64_t Offset;
+
+        bool operator == (const Key& other) const { return Source == other.Source && Offset == other.Offset; }
+    };
+
+    struct KeyHash
+    {
+        size_t operator () (const Key& key) const
+        {
+            return std::hash<const void*>()(key.Source) ^ std::hash<uint64_t>()(key.Offset * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+
+    struct Entry
+    {
+        Key ItemKey;
+        std::weak_ptr<void> Source;
+        Data Bytes;
+    };
+
+    typedef std::list<Entry>::iterator EntryItr;
+
+    void Remove(EntryItr entry)
+    {
+        BytesUsed -= entry->Bytes->size();
+        Items.erase(entry->ItemKey);
+        Order.erase(entry);
+    }
+
+    void Trim()
+    {
+        while (BytesUsed > Budget && !Order.empty())
+        {
+            Remove(std::prev(Order.end()));
+            ++Evictions;
+        }
+    }
+
+    std::mutex Lock;
+    std::list<Entry> Order;
+    std::unordered_map<Key, EntryItr, KeyHash> Items;
+    uint64_t Budget = 0;
+    uint64_t BytesUsed = 0;
+    uint64_t Hits = 0;
+    uint64_t Misses = 0;
+    uint64_t Evictions = 0;
+};
+
+#endif //RLASSETS_CACHE_H
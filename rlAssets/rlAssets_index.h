@@ -0,0 +1,460 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAssets * Simple Asset Managment System for Raylib
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+#ifndef RLASSETS_INDEX_H
+#define RLASSETS_INDEX_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <string.h>
+
+/// <summary>
+/// Folds a path character to the case used for lookups
+/// </summary>
+inline unsigned char rlas_FoldPathChar(char c)
+{
+    unsigned char u = static_cast<unsigned char>(c);
+    return (u >= 'a' && u <= 'z') ? static_cast<unsigned char>(u - ('a' - 'A')) : u;
+}
+
+/// <summary>
+/// Computes a case insensitive FNV-1a hash of a path without making a copy of it
+/// </summary>
+/// <param name="path">The path to hash</param>
+/// <returns>The hash value, never 0</returns>
+inline uint64_t rlas_HashPath(const char* path, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= rlas_FoldPathChar(path[i]);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash == 0 ? 1 : hash;
+}
+
+inline uint64_t rlas_HashPath(const char* path)
+{
+    return rlas_HashPath(path, strlen(path));
+}
+
+/// <summary>
+/// Case insensitive compare of a path against a stored name
+/// </summary>
+inline bool rlas_PathEquals(const char* path, size_t length, const std::string& name)
+{
+    if (length != name.size())
+        return false;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        if (rlas_FoldPathChar(path[i]) != rlas_FoldPathChar(name[i]))
+            return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// Open addressing hash table of virtual asset paths
+/// Lookups hash the caller's path in place, so finding an item never allocates
+/// Items are stored densely in the order they were first added, setting an existing path replaces the item in place
+/// </summary>
+template<class T>
+class rlas_PathIndex
+{
+public:
+    rlas_PathIndex()
+    {
+        Clear();
+    }
+
+    void Clear()
+    {
+        Names.clear();
+        Items.clear();
+        Slots.assign(16, Slot());
+        Mask = Slots.size() - 1;
+    }
+
+    size_t Size() const { return Items.size(); }
+
+    const std::string& NameAt(size_t index) const { return Names[index]; }
+    T& ItemAt(size_t index) { return Items[index]; }
+    const T& ItemAt(size_t index) const { return Items[index]; }
+
+    T* Find(const char* path)
+    {
+        if (path == nullptr)
+            return nullptr;
+
+        return Find(path, strlen(path));
+    }
+
+    T* Find(const char* path, size_t length)
+    {
+        size_t index = FindIndex(path, length, rlas_HashPath(path, length));
+        return index == NotFound ? nullptr : &Items[index];
+    }
+
+    const T* Find(const char* path) const
+    {
+        return const_cast<rlas_PathIndex*>(this)->Find(path);
+    }
+
+    const T* Find(const char* path, size_t length) const
+    {
+        return const_cast<rlas_PathIndex*>(this)->Find(path, length);
+    }
+
+    /// <summary>
+    /// Finds where the item for a path is stored, the index stays the same until an item is removed
+    /// </summary>
+    /// <returns>False if the path is not in the index</returns>
+    bool IndexOf(const char* path, size_t& index) const
+    {
+        if (path == nullptr)
+            return false;
+
+        size_t length = strlen(path);
+        index = FindIndex(path, length, rlas_HashPath(path, length));
+        return index != NotFound;
+    }
+
+    /// <summary>
+    /// Finds where the item for a path is stored using a hash from rlas_HashPath, for callers that look the same path up in more than one index
+    /// </summary>
+    bool IndexOf(const char* path, size_t length, uint64_t hash, size_t& index) const
+    {
+        index = FindIndex(path, length, hash);
+        return index != NotFound;
+    }
+
+    /// <summary>
+    /// Adds an item, or replaces the item already stored for the same path (ignoring case)
+    /// </summary>
+    T& Set(const std::string& path, const T& item)
+    {
+        uint64_t hash = rlas_HashPath(path.c_str(), path.size());
+        size_t index = FindIndex(path.c_str(), path.size(), hash);
+        if (index != NotFound)
+        {
+            Items[index] = item;
+            return Items[index];
+        }
+
+        if ((Items.size() + 1) * 4 > Slots.size() * 3)
+            Grow();
+
+        Names.push_back(path);
+        Items.push_back(item);
+        Insert(hash, static_cast<uint32_t>(Items.size()));
+
+        return Items.back();
+    }
+
+    /// <summary>
+    /// Removes the item stored for a path
+    /// The last item is moved into the removed item's place, so after a removal the item at index (if any) was at Size()
+    /// </summary>
+    /// <param name="path">The path to remove</param>
+    /// <param name="index">Set to the index the removed item had</param>
+    /// <returns>True if the path was found</returns>
+    bool Remove(const std::string& path, size_t& index)
+    {
+        uint64_t hash = rlas_HashPath(path.c_str(), path.size());
+        size_t slot = FindSlot(path.c_str(), path.size(), hash);
+        if (slot == NotFound)
+            return false;
+
+        index = Slots[slot].Item - 1;
+        EraseSlot(slot);
+
+        size_t last = Items.size() - 1;
+        if (index != last)
+        {
+            uint64_t lastHash = rlas_HashPath(Names[last].c_str(), Names[last].size());
+            for (size_t i = lastHash & Mask; ; i = (i + 1) & Mask)
+            {
+                if (Slots[i].Item == last + 1)
+                {
+                    Slots[i].Item = static_cast<uint32_t>(index + 1);
+                    break;
+                }
+            }
+
+            Names[index] = std::move(Names[last]);
+            Items[index] = std::move(Items[last]);
+        }
+
+        Names.pop_back();
+        Items.pop_back();
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        uint64_t Hash = 0;
+        uint32_t Item = 0; // index + 1, 0 is an empty slot
+    };
+
+    static const size_t NotFound = static_cast<size_t>(-1);
+
+    size_t FindSlot(const char* path, size_t length, uint64_t hash) const
+    {
+        for (size_t i = hash & Mask; Slots[i].Item != 0; i = (i + 1) & Mask)
+        {
+            if (Slots[i].Hash == hash && rlas_PathEquals(path, length, Names[Slots[i].Item - 1]))
+                return i;
+        }
+        return NotFound;
+    }
+
+    size_t FindIndex(const char* path, size_t length, uint64_t hash) const
+    {
+        size_t slot = FindSlot(path, length, hash);
+        return slot == NotFound ? NotFound : Slots[slot].Item - 1;
+    }
+
+    // empties a slot, shifting back any later slot in the same probe run that would no longer be reachable
+    void EraseSlot(size_t slot)
+    {
+        for (size_t next = (slot + 1) & Mask; Slots[next].Item != 0; next = (next + 1) & Mask)
+        {
+            size_t home = Slots[next].Hash & Mask;
+            bool reachable = slot <= next ? (home > slot && home <= next) : (home > slot || home <= next);
+            if (!reachable)
+            {
+                Slots[slot] = Slots[next];
+                slot = next;
+            }
+        }
+        Slots[slot] = Slot();
+    }
+
+    void Insert(uint64_t hash, uint32_t item)
+    {
+        size_t i = hash & Mask;
+        while (Slots[i].Item != 0)
+            i = (i + 1) & Mask;
+
+        Slots[i].Hash = hash;
+        Slots[i].Item = item;
+    }
+
+    void Grow()
+    {
+        std::vector<Slot> old;
+        old.swap(Slots);
+        Slots.assign(old.size() * 2, Slot());
+        Mask = Slots.size() - 1;
+
+        for (auto& slot : old)
+        {
+            if (slot.Item != 0)
+                Insert(slot.Hash, slot.Item);
+        }
+    }
+
+    std::vector<Slot> Slots;
+    std::vector<std::string> Names;
+    std::vector<T> Items;
+    size_t Mask = 0;
+};
+
+/// <summary>
+/// Directory structure of the items in a path index
+/// Each directory knows its own files and sub directories, so listing a directory only visits what is in it
+/// Directories are keyed by their path without a trailing '/', the root directory is ""
+/// </summary>
+class rlas_DirectoryTree
+{
+public:
+    struct Node
+    {
+        std::vector<uint32_t> Files;    // item indexes in the path index
+        std::vector<uint32_t> SubDirs;  // node indexes
+        uint32_t TotalFiles = 0;        // files in this directory and all sub directories
+    };
+
+    rlas_DirectoryTree()
+    {
+        Clear();
+    }
+
+    void Clear()
+    {
+        Directories.Clear();
+        Nodes.clear();
+        Nodes.push_back(Node());
+        Directories.Set(std::string(), 0);
+    }
+
+    /// <summary>
+    /// Adds an item to the directory of its path, creating any directories that do not exist yet
+    /// </summary>
+    void AddFile(const std::string& path, uint32_t item)
+    {
+        uint32_t node = 0;
+        ++Nodes[0].TotalFiles;
+
+        for (size_t end = path.find('/'); end != std::string::npos; end = path.find('/', end + 1))
+        {
+            uint32_t* existing = Directories.Find(path.c_str(), end);
+            if (existing == nullptr)
+            {
+                uint32_t subDir = static_cast<uint32_t>(Nodes.size());
+                Nodes.push_back(Node());
+                Nodes[node].SubDirs.push_back(subDir);
+                existing = &Directories.Set(path.substr(0, end), subDir);
+            }
+
+            node = *existing;
+            ++Nodes[node].TotalFiles;
+        }
+
+        Nodes[node].Files.push_back(item);
+    }
+
+    /// <summary>
+    /// Removes an item from the directory of its path, the directories themselves are kept
+    /// </summary>
+    void RemoveFile(const std::string& path, uint32_t item)
+    {
+        std::vector<uint32_t> parents;
+        uint32_t node = ParentOf(path, &parents);
+        if (node == NoNode)
+            return;
+
+        std::vector<uint32_t>& files = Nodes[node].Files;
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            if (files[i] != item)
+                continue;
+
+            files.erase(files.begin() + i);
+            for (uint32_t parent : parents)
+                --Nodes[parent].TotalFiles;
+            return;
+        }
+    }
+
+    /// <summary>
+    /// Updates the item index stored for a path, used when the path index moves an item
+    /// </summary>
+    void MoveFile(const std::string& path, uint32_t from, uint32_t to)
+    {
+        uint32_t node = ParentOf(path, nullptr);
+        if (node == NoNode)
+            return;
+
+        for (uint32_t& file : Nodes[node].Files)
+        {
+            if (file == from)
+            {
+                file = to;
+                return;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Finds a directory, leading and trailing '/' characters are ignored
+    /// </summary>
+    const Node* Find(const char* path) const
+    {
+        if (path == nullptr)
+            return &Nodes[0];
+
+        while (*path == '/')
+            ++path;
+
+        size_t length = strlen(path);
+        while (length > 0 && path[length - 1] == '/')
+            --length;
+
+        const uint32_t* node = Directories.Find(path, length);
+        return node == nullptr ? nullptr : &Nodes[*node];
+    }
+
+    /// <summary>
+    /// Calls a function for every item in a directory, and optionally all of its sub directories
+    /// The function returns false to stop
+    /// </summary>
+    template<class F>
+    bool Visit(const Node& node, bool recursive, F function) const
+    {
+        for (uint32_t item : node.Files)
+        {
+            if (!function(item))
+                return false;
+        }
+
+        if (recursive)
+        {
+            for (uint32_t subDir : node.SubDirs)
+            {
+                if (!Visit(Nodes[subDir], true, function))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static const uint32_t NoNode = static_cast<uint32_t>(-1);
+
+    // the directory node of a path, optionally with every directory from the root down to it
+    uint32_t ParentOf(const std::string& path, std::vector<uint32_t>* chain) const
+    {
+        if (chain != nullptr)
+            chain->push_back(0);
+
+        uint32_t node = 0;
+        for (size_t end = path.find('/'); end != std::string::npos; end = path.find('/', end + 1))
+        {
+            const uint32_t* existing = Directories.Find(path.c_str(), end);
+            if (existing == nullptr)
+                return NoNode;
+
+            node = *existing;
+            if (chain != nullptr)
+                chain->push_back(node);
+        }
+        return node;
+    }
+
+    rlas_PathIndex<uint32_t> Directories;
+    std::vector<Node> Nodes;
+};
+
+#endif //RLASSETS_INDEX_H
@@ -0,0 +1,523 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAssets * Simple Asset Managment System for Raylib
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+
+#ifndef RLASSETS_PACK_H
+#define RLASSETS_PACK_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+// the deflate code comes from miniz, which may only be compiled into one file of a program
+#include "zip_file.h"
+#include "rlAssets_index.h"
+#include "rlAssets_platforms.h"
+
+// rlAssets pack files (.rlpak)
+// [header][block data][table of contents]
+// Every entry is split into blocks of the same uncompressed size, each block is deflated on its own (or stored when that is not smaller)
+// so reading part of an entry only decompresses the blocks the read touches.
+// The table of contents is 16 byte aligned and holds the name hash slots, the entries, the blocks and then the names.
+// Values are stored in the byte order of the machine that wrote them, the header has a marker so a reader on a different machine rejects the file.
+
+static const char rlas_PackMagic[4] = { 'R', 'L', 'P', 'K' };
+static const uint32_t rlas_PackVersion = 1;
+static const uint32_t rlas_PackByteOrder = 0x01020304;
+static const uint32_t rlas_PackAlignment = 16;
+static const uint32_t rlas_PackDefaultBlockSize = 64 * 1024;
+
+typedef struct
+{
+    char Magic[4];
+    uint32_t Version;
+    uint32_t ByteOrder;
+    uint32_t BlockSize;     // the uncompressed size of every block but the last one of an entry
+    uint32_t EntryCount;
+    uint32_t SlotCount;     // a power of 2
+    uint32_t BlockCount;
+    uint32_t NamesSize;
+    uint64_t TocOffset;
+    uint64_t Reserved;
+}rlas_PackHeader;
+
+typedef struct
+{
+    uint64_t Hash;          // rlas_HashPath of the name
+    uint32_t Entry;         // entry index + 1, 0 is an empty slot
+    uint32_t Reserved;
+}rlas_PackSlot;
+
+typedef struct
+{
+    uint64_t Size;          // uncompressed size
+    uint32_t FirstBlock;
+    uint32_t BlockCount;
+    uint32_t NameOffset;    // in the names, which are not null terminated
+    uint32_t NameLength;
+    uint32_t Crc;           // crc32 of the uncompressed data
+    uint32_t Reserved;
+}rlas_PackEntry;
+
+enum rlas_PackBlockFlags : uint32_t
+{
+    PackBlockStored = 0,
+    PackBlockDeflated = 1,
+};
+
+typedef struct
+{
+    uint64_t Offset;        // from the start of the file
+    uint32_t CompressedSize;
+    uint32_t Flags;
+}rlas_PackBlock;
+
+static_assert(sizeof(rlas_PackHeader) == 48 && sizeof(rlas_PackSlot) == 16 && sizeof(rlas_PackEntry) == 32 && sizeof(rlas_PackBlock) == 16, "pack structures must keep the table of contents aligned");
+
+/// <summary>
+/// Reads a pack file
+/// The table of contents is read when the pack is opened, entry data is read from a mapping of the file or with locked file reads when the file can not be mapped
+/// Reads are safe from multiple threads
+/// </summary>
+class rlas_PackFile
+{
+public:
+    ~rlas_PackFile()
+    {
+        Close();
+    }
+
+    /// <summary>
+    /// Opens a pack and reads the table of contents
+    /// </summary>
+    /// <param name="path">The pack file in OS format</param>
+    /// <param name="map">Map the file into memory instead of reading it with file IO</param>
+    /// <returns>False if the file is missing or is not a valid pack</returns>
+    bool Open(const std::string& path, bool map)
+    {
+        Close();
+
+        if (map && rlas_MapFile(path.c_str(), &Mapping))
+        {
+            Mapped = true;
+            FileSize = Mapping.Size;
+        }
+        else
+        {
+            File = rlas_OpenReadFile(path.c_str(), &FileSize);
+            if (File < 0)
+                return false;
+        }
+
+        if (ReadTableOfContents())
+            return true;
+
+        Close();
+        return false;
+    }
+
+    void Close()
+    {
+        if (Mapped)
+            rlas_UnmapFile(&Mapping);
+        if (File >= 0)
+            rlas_CloseReadFile(File);
+
+        Mapped = false;
+        File = -1;
+        FileSize = 0;
+        Entries.clear();
+        Blocks.clear();
+        Slots.clear();
+        Names.clear();
+    }
+
+    uint32_t Count() const { return (uint32_t)Entries.size(); }
+    uint32_t GetBlockSize() const { return BlockSize; }
+    const rlas_PackEntry& EntryAt(uint32_t entry) const { return Entries[entry]; }
+
+    std::string NameAt(uint32_t entry) const
+    {
+        return std::string(Names.data() + Entries[entry].NameOffset, Entries[entry].NameLength);
+    }
+
+    /// <summary>
+    /// Finds an entry by name, ignoring case
+    /// </summary>
+    /// <returns>The entry index, -1 if there is no entry with the name</returns>
+    int Find(const char* name, size_t length) const
+    {
+        if (Slots.empty())
+            return -1;
+
+        uint64_t hash = rlas_HashPath(name, length);
+        size_t mask = Slots.size() - 1;
+        for (size_t i = hash & mask; Slots[i].Entry != 0; i = (i + 1) & mask)
+        {
+            const rlas_PackEntry& entry = Entries[Slots[i].Entry - 1];
+            if (Slots[i].Hash == hash && length == entry.NameLength)
+            {
+                bool equal = true;
+                for (size_t c = 0; c < length && equal; ++c)
+                    equal = rlas_FoldPathChar(name[c]) == rlas_FoldPathChar(Names[entry.NameOffset + c]);
+
+                if (equal)
+                    return (int)(Slots[i].Entry - 1);
+            }
+        }
+        return -1;
+    }
+
+    /// <summary>
+    /// Reads part of an entry, only the blocks that hold [offset, offset + size) are read and decompressed
+    /// </summary>
+    /// <param name="entry">The entry index</param>
+    /// <param name="offset">The first byte to read</param>
+    /// <param name="buffer">The destination, at least size bytes</param>
+    /// <param name="size">The number of bytes to read</param>
+    /// <returns>The number of bytes read, less than size at the end of the entry, 0 on a read or decompression error</returns>
+    size_t Read(uint32_t entry, uint64_t offset, void* buffer, size_t size) const
+    {
+        if (entry >= Entries.size())
+            return 0;
+
+        const rlas_PackEntry& info = Entries[entry];
+        if (offset >= info.Size || size == 0)
+            return 0;
+
+        size = (size_t)std::min<uint64_t>(size, info.Size - offset);
+        uint64_t end = offset + size;
+
+        std::vector<unsigned char> compressed;
+        std::vector<unsigned char> block;
+
+        for (uint64_t index = offset / BlockSize; index * BlockSize < end; ++index)
+        {
+            const rlas_PackBlock& source = Blocks[info.FirstBlock + (uint32_t)index];
+            uint64_t blockStart = index * BlockSize;
+            size_t blockSize = (size_t)std::min<uint64_t>(BlockSize, info.Size - blockStart);
+            size_t from = (size_t)(std::max(offset, blockStart) - blockStart);
+            size_t to = (size_t)(std::min(end, blockStart + blockSize) - blockStart);
+            unsigned char* destination = static_cast<unsigned char*>(buffer) + (blockStart + from - offset);
+
+            if (source.Flags == PackBlockStored)
+            {
+                if (!ReadAt(source.Offset + from, destination, to - from))
+                    return 0;
+                continue;
+            }
+
+            const unsigned char* data = nullptr;
+            if (Mapped)
+            {
+                data = static_cast<const unsigned char*>(Mapping.Data) + source.Offset;
+            }
+            else
+            {
+                compressed.resize(source.CompressedSize);
+                if (!ReadAt(source.Offset, compressed.data(), compressed.size()))
+                    return 0;
+                data = compressed.data();
+            }
+
+            // a whole block goes straight to the destination, part of one is inflated on the side
+            unsigned char* output = destination;
+            if (from != 0 || to != blockSize)
+            {
+                block.resize(blockSize);
+                output = block.data();
+            }
+
+            if (tinfl_decompress_mem_to_mem(output, blockSize, data, source.CompressedSize, 0) != blockSize)
+                return 0;
+
+            if (output != destination)
+                memcpy(destination, output + from, to - from);
+        }
+
+        return size;
+    }
+
+    /// <summary>
+    /// Gets a pointer to the data of an entry when the pack is mapped and every block of the entry is stored
+    /// </summary>
+    /// <returns>The entry data, nullptr if it has to be read</returns>
+    const void* StoredData(uint32_t entry) const
+    {
+        if (!Mapped || entry >= Entries.size() || Entries[entry].BlockCount == 0)
+            return nullptr;
+
+        const rlas_PackEntry& info = Entries[entry];
+
+        // blocks are written in order, so stored blocks of one entry are contiguous
+        for (uint32_t i = 0; i < info.BlockCount; ++i)
+        {
+            if (Blocks[info.FirstBlock + i].Flags != PackBlockStored)
+                return nullptr;
+        }
+
+        return static_cast<const unsigned char*>(Mapping.Data) + Blocks[info.FirstBlock].Offset;
+    }
+
+private:
+    bool ReadAt(uint64_t offset, void* buffer, size_t size) const
+    {
+        if (offset + size > FileSize)
+            return false;
+
+        if (Mapped)
+        {
+            memcpy(buffer, static_cast<const unsigned char*>(Mapping.Data) + offset, size);
+            return true;
+        }
+
+        // offsets are 64 bit on every OS, the lock is for Windows where a read moves the file position
+        std::lock_guard<std::mutex> lock(FileLock);
+        return rlas_ReadFileAt(File, offset, buffer, size) == size;
+    }
+
+    template<class T>
+    bool ReadArray(uint64_t& offset, std::vector<T>& items, size_t count)
+    {
+        items.resize(count);
+        if (count != 0 && !ReadAt(offset, items.data(), count * sizeof(T)))
+            return false;
+
+        offset += count * sizeof(T);
+        return true;
+    }
+
+    bool ReadTableOfContents()
+    {
+        rlas_PackHeader header;
+        if (!ReadAt(0, &header, sizeof(header)) || memcmp(header.Magic, rlas_PackMagic, sizeof(header.Magic)) != 0
+            || header.Version != rlas_PackVersion || header.ByteOrder != rlas_PackByteOrder || header.BlockSize == 0)
+            return false;
+
+        if (header.SlotCount == 0 || (header.SlotCount & (header.SlotCount - 1)) != 0 || header.SlotCount <= header.EntryCount)
+            return false;
+
+        uint64_t tocSize = (uint64_t)header.SlotCount * sizeof(rlas_PackSlot) + (uint64_t)header.EntryCount * sizeof(rlas_PackEntry)
+            + (uint64_t)header.BlockCount * sizeof(rlas_PackBlock) + header.NamesSize;
+        if (header.TocOffset > FileSize || tocSize > FileSize - header.TocOffset)
+            return false;
+
+        uint64_t offset = header.TocOffset;
+        if (!ReadArray(offset, Slots, header.SlotCount) || !ReadArray(offset, Entries, header.EntryCount)
+            || !ReadArray(offset, Blocks, header.BlockCount) || !ReadArray(offset, Names, header.NamesSize))
+            return false;
+
+        BlockSize = header.BlockSize;
+
+        // everything the reads rely on is checked once here
+        for (auto& slot : Slots)
+        {
+            if (slot.Entry > Entries.size())
+                return false;
+        }
+
+        for (auto& entry : Entries)
+        {
+            if ((uint64_t)entry.FirstBlock + entry.BlockCount > Blocks.size() || (uint64_t)entry.NameOffset + entry.NameLength > Names.size()
+                || entry.BlockCount != (entry.Size + BlockSize - 1) / BlockSize)
+                return false;
+        }
+
+        for (auto& block : Blocks)
+        {
+            if (block.Offset > header.TocOffset || block.CompressedSize > header.TocOffset - block.Offset
+                || (block.Flags != PackBlockStored && block.Flags != PackBlockDeflated))
+                return false;
+        }
+
+        return true;
+    }
+
+    rlas_FileMapping Mapping = { nullptr, 0, nullptr, nullptr };
+    bool Mapped = false;
+    int File = -1;
+    mutable std::mutex FileLock;
+    uint64_t FileSize = 0;
+
+    uint32_t BlockSize = rlas_PackDefaultBlockSize;
+    std::vector<rlas_PackSlot> Slots;
+    std::vector<rlas_PackEntry> Entries;
+    std::vector<rlas_PackBlock> Blocks;
+    std::vector<char> Names;
+};
+
+/// <summary>
+/// Writes a pack file, entries are compressed and written as they are added and the table of contents is written by Finish
+/// </summary>
+class rlas_PackWriter
+{
+public:
+    /// <param name="blockSize">The uncompressed size of each block, smaller blocks make small reads cheaper and compress worse</param>
+    /// <param name="level">The deflate level, 0 stores every block</param>
+    rlas_PackWriter(uint32_t blockSize = rlas_PackDefaultBlockSize, int level = 6) : BlockSize(std::max<uint32_t>(blockSize, 1)), Level(level)
+    {
+    }
+
+    ~rlas_PackWriter()
+    {
+        if (File != nullptr)
+            fclose(File);
+    }
+
+    bool Begin(const char* path)
+    {
+        File = fopen(path, "wb");
+        if (File == nullptr)
+            return false;
+
+        // the header is written again by Finish once the table of contents is known
+        rlas_PackHeader header = {};
+        Offset = 0;
+        return Write(&header, sizeof(header));
+    }
+
+    /// <summary>
+    /// Adds an entry
+    /// </summary>
+    /// <returns>False if the name is already in the pack (ignoring case) or the data could not be written</returns>
+    bool Add(const std::string& name, const void* data, uint64_t size)
+    {
+        if (File == nullptr || NameIndex.Find(name.c_str(), name.size()) != nullptr)
+            return false;
+
+        rlas_PackEntry entry = {};
+        entry.Size = size;
+        entry.FirstBlock = (uint32_t)Blocks.size();
+        entry.BlockCount = (uint32_t)((size + BlockSize - 1) / BlockSize);
+        entry.NameOffset = (uint32_t)Names.size();
+        entry.NameLength = (uint32_t)name.size();
+        entry.Crc = (uint32_t)mz_crc32(MZ_CRC32_INIT, static_cast<const unsigned char*>(data), (size_t)size);
+
+        std::vector<unsigned char> compressed(BlockSize);
+        mz_uint flags = tdefl_create_comp_flags_from_zip_params(Level, -15, MZ_DEFAULT_STRATEGY);
+
+        for (uint64_t start = 0; start < size; start += BlockSize)
+        {
+            const unsigned char* input = static_cast<const unsigned char*>(data) + start;
+            size_t inputSize = (size_t)std::min<uint64_t>(BlockSize, size - start);
+
+            // 0 means the deflated block did not fit in the space of the stored block
+            size_t compressedSize = Level > 0 ? tdefl_compress_mem_to_mem(compressed.data(), inputSize - 1, input, inputSize, flags) : 0;
+
+            rlas_PackBlock block = {};
+            block.Offset = Offset;
+            block.Flags = compressedSize != 0 ? PackBlockDeflated : PackBlockStored;
+            block.CompressedSize = (uint32_t)(compressedSize != 0 ? compressedSize : inputSize);
+            if (!Write(compressedSize != 0 ? compressed.data() : input, block.CompressedSize))
+                return false;
+
+            Blocks.push_back(block);
+        }
+
+        NameIndex.Set(name, (uint32_t)Entries.size());
+        Names.insert(Names.end(), name.begin(), name.end());
+        Entries.push_back(entry);
+        return true;
+    }
+
+    bool Finish()
+    {
+        if (File == nullptr)
+            return false;
+
+        rlas_PackHeader header = {};
+        memcpy(header.Magic, rlas_PackMagic, sizeof(header.Magic));
+        header.Version = rlas_PackVersion;
+        header.ByteOrder = rlas_PackByteOrder;
+        header.BlockSize = BlockSize;
+        header.EntryCount = (uint32_t)Entries.size();
+        header.BlockCount = (uint32_t)Blocks.size();
+        header.NamesSize = (uint32_t)Names.size();
+
+        // at most half full, so a lookup for a missing name ends quickly
+        header.SlotCount = 16;
+        while (header.SlotCount < Entries.size() * 2)
+            header.SlotCount *= 2;
+
+        std::vector<rlas_PackSlot> slots(header.SlotCount, rlas_PackSlot());
+        for (uint32_t i = 0; i < Entries.size(); ++i)
+        {
+            uint64_t hash = rlas_HashPath(Names.data() + Entries[i].NameOffset, Entries[i].NameLength);
+            size_t slot = hash & (slots.size() - 1);
+            while (slots[slot].Entry != 0)
+                slot = (slot + 1) & (slots.size() - 1);
+
+            slots[slot].Hash = hash;
+            slots[slot].Entry = i + 1;
+        }
+
+        static const unsigned char padding[rlas_PackAlignment] = { 0 };
+        size_t pad = (size_t)((rlas_PackAlignment - Offset % rlas_PackAlignment) % rlas_PackAlignment);
+        header.TocOffset = Offset + pad;
+
+        bool written = Write(padding, pad)
+            && Write(slots.data(), slots.size() * sizeof(rlas_PackSlot))
+            && Write(Entries.data(), Entries.size() * sizeof(rlas_PackEntry))
+            && Write(Blocks.data(), Blocks.size() * sizeof(rlas_PackBlock))
+            && Write(Names.data(), Names.size())
+            && fseek(File, 0, SEEK_SET) == 0
+            && fwrite(&header, sizeof(header), 1, File) == 1;
+
+        written = fclose(File) == 0 && written;
+        File = nullptr;
+        return written;
+    }
+
+private:
+    bool Write(const void* data, size_t size)
+    {
+        if (size == 0)
+            return true;
+
+        Offset += size;
+        return fwrite(data, 1, size, File) == size;
+    }
+
+    uint32_t BlockSize;
+    int Level;
+    FILE* File = nullptr;
+    uint64_t Offset = 0;
+
+    rlas_PathIndex<uint32_t> NameIndex;
+    std::vector<rlas_PackEntry> Entries;
+    std::vector<rlas_PackBlock> Blocks;
+    std::vector<char> Names;
+};
+
+#endif //RLASSETS_PACK_H
@@ -28,20 +28,40 @@
 *
 **********************************************************************************************/
 
+#include "rlAssets_platforms.h"
+
 #include <string>
+#include <algorithm>
+#include <errno.h>
+#include <stdlib.h>
 
 #if defined(_WIN32)
 
 #include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 constexpr char PathDelim = '\\';
 
 #elif defined(__linux__)
 #include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <errno.h>
+#include <sys/syscall.h>
 constexpr char PathDelim = '/';
 
 #elif defined(__APPLE__)
 #include <sys/syslimits.h>
 #include <mach-o/dyld.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 constexpr char PathDelim = '/';
 
 #endif // OSs
@@ -127,4 +147,500 @@ const char* rlas_GetApplicationBasePath()
 #endif
     }
     return appDir.c_str();
-}
\ No newline at end of file
+}
+
+bool rlas_MapFile(const char* path, rlas_FileMapping* mapping)
+{
+    mapping->Data = nullptr;
+    mapping->Size = 0;
+    mapping->FileHandle = nullptr;
+    mapping->MapHandle = nullptr;
+
+    if (path == nullptr)
+        return false;
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (map == nullptr)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* data = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        CloseHandle(map);
+        CloseHandle(file);
+        return false;
+    }
+
+    mapping->Data = data;
+    mapping->Size = static_cast<size_t>(size.QuadPart);
+    mapping->FileHandle = file;
+    mapping->MapHandle = map;
+    return true;
+#else
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size <= 0)
+    {
+        close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, file, 0);
+    close(file); // the mapping keeps its own reference to the file
+
+    if (data == MAP_FAILED)
+        return false;
+
+    mapping->Data = data;
+    mapping->Size = static_cast<size_t>(info.st_size);
+    return true;
+#endif
+}
+
+void rlas_UnmapFile(rlas_FileMapping* mapping)
+{
+    if (mapping == nullptr || mapping->Data == nullptr)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(mapping->Data);
+    CloseHandle(static_cast<HANDLE>(mapping->MapHandle));
+    CloseHandle(static_cast<HANDLE>(mapping->FileHandle));
+#else
+    munmap(const_cast<void*>(mapping->Data), mapping->Size);
+#endif
+
+    mapping->Data = nullptr;
+    mapping->Size = 0;
+    mapping->FileHandle = nullptr;
+    mapping->MapHandle = nullptr;
+}
+
+#if !defined(_WIN32)
+void StampFromStat(const struct stat& info, rlas_FileStamp* stamp)
+{
+    stamp->Size = static_cast<int64_t>(info.st_size);
+#if defined(__APPLE__)
+    stamp->ModTime = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+    stamp->ModTime = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+}
+#endif
+
+bool rlas_ListDirectory(const char* path, std::vector<rlas_DirectoryEntry>& entries, bool stamps)
+{
+    if (path == nullptr)
+        return false;
+
+#if defined(_WIN32)
+    std::string search = path;
+    if (!search.empty() && search.back() != '\\' && search.back() != '/')
+        search += PathDelim;
+    search += "*";
+
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA(search.c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE)
+        return false;
+
+    do
+    {
+        if (data.cFileName[0] == '.')
+            continue;
+
+        rlas_DirectoryEntry entry;
+        entry.Name = data.cFileName;
+        entry.IsDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        entry.Stamp.Size = entry.IsDirectory ? 0 : (static_cast<int64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+        entry.Stamp.ModTime = entry.IsDirectory ? 0 : (static_cast<int64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+        entries.push_back(entry);
+    } while (FindNextFileA(find, &data));
+
+    FindClose(find);
+    return true;
+#else
+    DIR* dir = opendir(path);
+    if (dir == nullptr)
+        return false;
+
+    int dirFile = dirfd(dir);
+
+    while (struct dirent* item = readdir(dir))
+    {
+        if (item->d_name[0] == '.')
+            continue;
+
+        rlas_DirectoryEntry entry;
+        entry.Name = item->d_name;
+        entry.Stamp.Size = 0;
+        entry.Stamp.ModTime = 0;
+
+        if (item->d_type == DT_DIR || (item->d_type == DT_REG && !stamps))
+        {
+            entry.IsDirectory = item->d_type == DT_DIR;
+        }
+        else
+        {
+            // links, file systems that do not report a type and files that need a stamp need a stat
+            struct stat info;
+            if (fstatat(dirFile, item->d_name, &info, 0) != 0)
+                continue;
+
+            if (!S_ISDIR(info.st_mode) && !S_ISREG(info.st_mode))
+                continue;
+
+            entry.IsDirectory = S_ISDIR(info.st_mode);
+            if (!entry.IsDirectory && stamps)
+                StampFromStat(info, &entry.Stamp);
+        }
+
+        entries.push_back(entry);
+    }
+
+    closedir(dir);
+    return true;
+#endif
+}
+
+bool rlas_GetFileStamp(const char* path, rlas_FileStamp* stamp)
+{
+    stamp->Size = 0;
+    stamp->ModTime = 0;
+
+    if (path == nullptr)
+        return false;
+
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data))
+        return false;
+
+    stamp->Size = (static_cast<int64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    stamp->ModTime = (static_cast<int64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat info;
+    if (stat(path, &info) != 0)
+        return false;
+
+    StampFromStat(info, stamp);
+#endif
+    return true;
+}
+
+int rlas_OpenReadFile(const char* path, uint64_t* size)
+{
+    *size = 0;
+    if (path == nullptr)
+        return -1;
+
+#if defined(_WIN32)
+    int file = -1;
+    if (_sopen_s(&file, path, _O_RDONLY | _O_BINARY | _O_SEQUENTIAL, _SH_DENYNO, 0) != 0)
+        return -1;
+
+    struct _stat64 info;
+    if (_fstat64(file, &info) != 0)
+    {
+        _close(file);
+        return -1;
+    }
+#else
+    int file = open(path, O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+        return -1;
+
+    struct stat info;
+    if (fstat(file, &info) != 0)
+    {
+        close(file);
+        return -1;
+    }
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(file, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+
+    *size = static_cast<uint64_t>(info.st_size);
+    return file;
+}
+
+size_t rlas_ReadFileAt(int file, uint64_t offset, void* buffer, size_t size)
+{
+    char* destination = static_cast<char*>(buffer);
+    size_t done = 0;
+
+#if defined(_WIN32)
+    if (_lseeki64(file, static_cast<__int64>(offset), SEEK_SET) < 0)
+        return 0;
+
+    while (done < size)
+    {
+        unsigned int count = static_cast<unsigned int>(std::min<size_t>(size - done, 0x40000000));
+        int read = _read(file, destination + done, count);
+        if (read <= 0)
+            break;
+        done += static_cast<size_t>(read);
+    }
+#else
+    while (done < size)
+    {
+        ssize_t read = pread(file, destination + done, size - done, static_cast<off_t>(offset + done));
+        if (read < 0 && errno == EINTR)
+            continue;
+        if (read <= 0)
+            break;
+        done += static_cast<size_t>(read);
+    }
+#endif
+
+    return done;
+}
+
+void rlas_CloseReadFile(int file)
+{
+#if defined(_WIN32)
+    _close(file);
+#else
+    close(file);
+#endif
+}
+
+bool rlas_CreateDirectory(const char* path)
+{
+    if (path == nullptr)
+        return false;
+
+#if defined(_WIN32)
+    if (CreateDirectoryA(path, nullptr))
+        return true;
+
+    DWORD attributes = GetFileAttributesA(path);
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+    if (mkdir(path, 0755) == 0)
+        return true;
+
+    struct stat info;
+    return stat(path, &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+}
+
+FILE* rlas_CreateUniqueFile(const char* path, std::string& uniquePath)
+{
+    uniquePath.clear();
+    if (path == nullptr)
+        return nullptr;
+
+#if defined(_WIN32)
+    std::string directory = path;
+    size_t slash = directory.find_last_of("\\/");
+    directory = slash == std::string::npos ? std::string(".") : directory.substr(0, slash);
+
+    char name[MAX_PATH];
+    if (GetTempFileNameA(directory.c_str(), "rla", 0, name) == 0)
+        return nullptr;
+
+    FILE* file = nullptr;
+    if (fopen_s(&file, name, "wb") != 0 || file == nullptr)
+    {
+        DeleteFileA(name);
+        return nullptr;
+    }
+    uniquePath = name;
+    return file;
+#else
+    std::string name = std::string(path) + ".XXXXXX";
+    int handle = mkstemp(&name[0]);
+    if (handle < 0)
+        return nullptr;
+
+    // mkstemp makes the file private, files shared through a cache get the usual permissions
+    fchmod(handle, 0644);
+
+    FILE* file = fdopen(handle, "wb");
+    if (file == nullptr)
+    {
+        close(handle);
+        unlink(name.c_str());
+        return nullptr;
+    }
+    uniquePath = name;
+    return file;
+#endif
+}
+
+bool rlas_ReplaceFile(const char* from, const char* to)
+{
+#if defined(_WIN32)
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+#if defined(__linux__) && defined(SYS_memfd_create)
+
+int rlas_CreateMemoryFile(const char* name, const void* data, size_t size, std::string& path)
+{
+    // called through syscall so older C libraries without the memfd_create wrapper still build
+    int handle = (int)syscall(SYS_memfd_create, name, 1U /* MFD_CLOEXEC */);
+    if (handle < 0)
+        return -1;
+
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+        ssize_t written = write(handle, bytes, size);
+        if (written < 0 && errno == EINTR)
+            continue;
+
+        if (written <= 0)
+        {
+            close(handle);
+            return -1;
+        }
+
+        bytes += written;
+        size -= (size_t)written;
+    }
+
+    path = "/proc/self/fd/" + std::to_string(handle);
+    return handle;
+}
+
+void rlas_CloseMemoryFile(int handle)
+{
+    if (handle >= 0)
+        close(handle);
+}
+
+#else
+
+int rlas_CreateMemoryFile(const char* name, const void* data, size_t size, std::string& path)
+{
+    return -1;
+}
+
+void rlas_CloseMemoryFile(int handle)
+{
+}
+
+#endif // OSs
+
+#if defined(__linux__)
+
+int rlas_OpenDirectoryWatcher()
+{
+    return inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+void rlas_CloseDirectoryWatcher(int watcher)
+{
+    if (watcher >= 0)
+        close(watcher);
+}
+
+int rlas_AddDirectoryWatch(int watcher, const char* path)
+{
+    if (watcher < 0 || path == nullptr)
+        return -1;
+
+    // close write rather than modify, so a file is reported once it has been written out
+    return inotify_add_watch(watcher, path, IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+}
+
+void rlas_RemoveDirectoryWatch(int watcher, int watch)
+{
+    if (watcher >= 0 && watch >= 0)
+        inotify_rm_watch(watcher, watch);
+}
+
+bool rlas_ReadDirectoryWatcher(int watcher, std::vector<rlas_WatchEvent>& events)
+{
+    if (watcher < 0)
+        return false;
+
+    alignas(struct inotify_event) char buffer[16384];
+    while (true)
+    {
+        ssize_t size = read(watcher, buffer, sizeof(buffer));
+        if (size < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+
+        if (size == 0)
+            return true;
+
+        for (ssize_t offset = 0; offset < size;)
+        {
+            const struct inotify_event* notify = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += sizeof(struct inotify_event) + notify->len;
+
+            rlas_WatchEvent event;
+            event.Watch = notify->wd;
+            if (notify->len > 0)
+                event.Name = notify->name;
+
+            if (notify->mask & IN_Q_OVERFLOW)
+                event.Type = WatchOverflow;
+            else if (notify->mask & IN_IGNORED)
+                event.Type = WatchRemoved;
+            else if (event.Name.empty() || event.Name[0] == '.')
+                continue;
+            else if (notify->mask & IN_ISDIR)
+                event.Type = (notify->mask & (IN_DELETE | IN_MOVED_FROM)) ? WatchDirectoryRemoved : WatchDirectoryAdded;
+            else
+                event.Type = (notify->mask & (IN_DELETE | IN_MOVED_FROM)) ? WatchFileRemoved : WatchFileChanged;
+
+            events.push_back(event);
+        }
+    }
+}
+
+#else
+
+// other OSs do not support watching yet, resource paths are only read when they are added
+
+int rlas_OpenDirectoryWatcher()
+{
+    return -1;
+}
+
+void rlas_CloseDirectoryWatcher(int watcher)
+{
+}
+
+int rlas_AddDirectoryWatch(int watcher, const char* path)
+{
+    return -1;
+}
+
+void rlas_RemoveDirectoryWatch(int watcher, int watch)
+{
+}
+
+bool rlas_ReadDirectoryWatcher(int watcher, std::vector<rlas_WatchEvent>& events)
+{
+    return false;
+}
+
+#endif // OSs
@@ -0,0 +1,202 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAssets * Simple Asset Managment System for Raylib
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+#ifndef RLASSETS_PLATFORMS_H
+#define RLASSETS_PLATFORMS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Internal OS specific helpers for rlAssets, implemented in rlAssets_platforms.cpp
+// kept out of rlAssets.cpp so that OS headers are never mixed with raylib.h
+
+typedef struct
+{
+    const void* Data;
+    size_t Size;
+    void* FileHandle;
+    void* MapHandle;
+}rlas_FileMapping;
+
+/// <summary>
+/// Maps a file read only into memory, pages are loaded by the OS as they are accessed
+/// </summary>
+/// <param name="path">The path on disk of the file to map</param>
+/// <param name="mapping">The mapping to fill out</param>
+/// <returns>True if the file was mapped</returns>
+bool rlas_MapFile(const char* path, rlas_FileMapping* mapping);
+
+/// <summary>
+/// Releases a mapping created by rlas_MapFile
+/// </summary>
+void rlas_UnmapFile(rlas_FileMapping* mapping);
+
+typedef struct
+{
+    int64_t Size;
+    int64_t ModTime;    // last write time in OS specific units, only useful for comparing against another stamp
+}rlas_FileStamp;
+
+typedef struct
+{
+    std::string Name;
+    bool IsDirectory;
+    rlas_FileStamp Stamp;   // only set for files, and only when stamps are requested
+}rlas_DirectoryEntry;
+
+/// <summary>
+/// Lists the files and sub directories in a directory with a single pass over the directory
+/// Hidden entries (starting with '.') are skipped
+/// Safe to call from multiple threads
+/// </summary>
+/// <param name="path">The directory to list in OS format</param>
+/// <param name="entries">The list to add the entries to</param>
+/// <param name="stamps">Also get the size and modification time of files, free on Windows, one stat per file elsewhere</param>
+/// <returns>False if the directory could not be opened</returns>
+bool rlas_ListDirectory(const char* path, std::vector<rlas_DirectoryEntry>& entries, bool stamps = false);
+
+/// <summary>
+/// Gets the size and modification time of a file or directory
+/// </summary>
+/// <param name="path">The path in OS format</param>
+/// <param name="stamp">The stamp to fill out</param>
+/// <returns>False if the path does not exist</returns>
+bool rlas_GetFileStamp(const char* path, rlas_FileStamp* stamp);
+
+/// <summary>
+/// Opens a file for reading with a hint to the OS that it will be read from start to end
+/// </summary>
+/// <param name="path">The path in OS format</param>
+/// <param name="size">Set to the size of the file</param>
+/// <returns>The file handle, -1 if the file could not be opened</returns>
+int rlas_OpenReadFile(const char* path, uint64_t* size);
+
+/// <summary>
+/// Reads from an offset in a file opened by rlas_OpenReadFile, without a separate seek where the OS allows it
+/// Keeps reading until size bytes are read or the end of the file is reached
+/// </summary>
+/// <returns>The number of bytes read</returns>
+size_t rlas_ReadFileAt(int file, uint64_t offset, void* buffer, size_t size);
+
+/// <summary>
+/// Closes a file opened by rlas_OpenReadFile
+/// </summary>
+void rlas_CloseReadFile(int file);
+
+/// <summary>
+/// Creates a directory, the parent directory must exist
+/// </summary>
+/// <param name="path">The path in OS format</param>
+/// <returns>True if the directory was created or already exists</returns>
+bool rlas_CreateDirectory(const char* path);
+
+/// <summary>
+/// Creates a new file with a name no other thread or process is using, in the same directory as a path (mkstemp, GetTempFileName on Windows)
+/// </summary>
+/// <param name="path">The path the file will later replace, in OS format</param>
+/// <param name="uniquePath">Set to the path of the new file</param>
+/// <returns>The file opened for binary writing, nullptr if it could not be created</returns>
+FILE* rlas_CreateUniqueFile(const char* path, std::string& uniquePath);
+
+/// <summary>
+/// Renames a file over another one in a single step, so readers see either the old file or the new one
+/// </summary>
+/// <returns>True if the file was moved</returns>
+bool rlas_ReplaceFile(const char* from, const char* to);
+
+/// <summary>
+/// Creates an anonymous file in memory that holds a copy of some data (memfd on Linux)
+/// The file can be opened by path from this process until it is closed
+/// </summary>
+/// <param name="name">A name for the file, only used for debugging</param>
+/// <param name="data">The contents of the file</param>
+/// <param name="size">The size of the data</param>
+/// <param name="path">Set to a path that opens the file</param>
+/// <returns>The handle of the file, -1 if memory files are not supported on this OS or the file could not be created</returns>
+int rlas_CreateMemoryFile(const char* name, const void* data, size_t size, std::string& path);
+
+/// <summary>
+/// Closes a file created by rlas_CreateMemoryFile, its memory is freed once nothing else has it open
+/// </summary>
+void rlas_CloseMemoryFile(int handle);
+
+typedef enum
+{
+    WatchFileChanged,       // a file was created, written or moved into the directory
+    WatchFileRemoved,       // a file was deleted or moved out of the directory
+    WatchDirectoryAdded,    // a sub directory was created or moved into the directory
+    WatchDirectoryRemoved,  // a sub directory was deleted or moved out of the directory
+    WatchRemoved,           // the watch is gone, the directory itself was deleted or the watch was removed
+    WatchOverflow,          // the OS dropped events, the watched directories need to be read again
+}rlas_WatchEventType;
+
+typedef struct
+{
+    int Watch;
+    rlas_WatchEventType Type;
+    std::string Name;       // the name of the entry in the watched directory
+}rlas_WatchEvent;
+
+/// <summary>
+/// Creates a watcher that reports changes in a set of directories (inotify on Linux)
+/// </summary>
+/// <returns>The watcher, -1 if watching is not supported on this OS</returns>
+int rlas_OpenDirectoryWatcher();
+
+/// <summary>
+/// Closes a watcher and all of its watches
+/// </summary>
+void rlas_CloseDirectoryWatcher(int watcher);
+
+/// <summary>
+/// Starts watching a directory, sub directories are not included
+/// Adding the same directory again returns the same watch
+/// </summary>
+/// <returns>The watch, -1 if the directory can not be watched</returns>
+int rlas_AddDirectoryWatch(int watcher, const char* path);
+
+/// <summary>
+/// Stops watching a directory
+/// </summary>
+void rlas_RemoveDirectoryWatch(int watcher, int watch);
+
+/// <summary>
+/// Reads the events that have happened since the last read without waiting for new ones
+/// Hidden entries (starting with '.') are skipped
+/// </summary>
+/// <param name="watcher">The watcher to read</param>
+/// <param name="events">The list to add the events to</param>
+/// <returns>False if the watcher could not be read</returns>
+bool rlas_ReadDirectoryWatcher(int watcher, std::vector<rlas_WatchEvent>& events);
+
+#endif //RLASSETS_PLATFORMS_H
@@ -0,0 +1,183 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAssets * Simple Asset Managment System for Raylib
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+#ifndef RLASSETS_POOL_H
+#define RLASSETS_POOL_H
+
+#include <mutex>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/// <summary>
+/// Pool of buffers in power of two size classes, for data that is loaded, used and released again soon after
+/// Released buffers are kept for reuse up to a byte budget, so a long session reuses the same few blocks instead of fragmenting the heap
+/// Safe to use from multiple threads
+/// </summary>
+class rlas_BufferPool
+{
+public:
+    struct Stats
+    {
+        uint64_t Acquires = 0;
+        uint64_t Reuses = 0;
+        uint64_t BytesIdle = 0;
+        uint64_t Budget = 0;
+    };
+
+    ~rlas_BufferPool()
+    {
+        SetBudget(0);
+    }
+
+    /// <summary>
+    /// Sets the number of bytes of released buffers to keep, 0 frees them all and stops pooling
+    /// </summary>
+    void SetBudget(uint64_t bytes)
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        Budget = bytes;
+        Trim();
+    }
+
+    /// <summary>
+    /// Gets a buffer with room for at least size bytes, must be returned with Release
+    /// </summary>
+    /// <returns>The buffer, nullptr if it could not be allocated</returns>
+    unsigned char* Acquire(size_t size)
+    {
+        int sizeClass = ClassOf(size);
+        {
+            std::unique_lock<std::mutex> lock(Lock);
+            ++Acquires;
+            if (sizeClass >= 0 && !Free[sizeClass].empty())
+            {
+                Header* header = Free[sizeClass].back();
+                Free[sizeClass].pop_back();
+                BytesIdle -= ClassSize(sizeClass);
+                ++Reuses;
+                return reinterpret_cast<unsigned char*>(header + 1);
+            }
+        }
+
+        size_t capacity = sizeClass >= 0 ? ClassSize(sizeClass) : size;
+        Header* header = static_cast<Header*>(malloc(sizeof(Header) + capacity));
+        if (header == nullptr)
+            return nullptr;
+
+        header->SizeClass = sizeClass;
+        return reinterpret_cast<unsigned char*>(header + 1);
+    }
+
+    /// <summary>
+    /// Returns a buffer from Acquire to the pool, or frees it if the pool is over budget
+    /// </summary>
+    void Release(unsigned char* buffer)
+    {
+        if (buffer == nullptr)
+            return;
+
+        Header* header = reinterpret_cast<Header*>(buffer) - 1;
+        if (header->SizeClass >= 0)
+        {
+            std::unique_lock<std::mutex> lock(Lock);
+            uint64_t size = ClassSize(header->SizeClass);
+            if (BytesIdle + size <= Budget)
+            {
+                Free[header->SizeClass].push_back(header);
+                BytesIdle += size;
+                return;
+            }
+        }
+
+        free(header);
+    }
+
+    Stats GetStats()
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        Stats stats;
+        stats.Acquires = Acquires;
+        stats.Reuses = Reuses;
+        stats.BytesIdle = BytesIdle;
+        stats.Budget = Budget;
+        return stats;
+    }
+
+private:
+    // keeps the data after it aligned the same as malloc
+    union Header
+    {
+        int SizeClass;      // -1 for buffers too large for a class, they are never pooled
+        max_align_t Align;
+    };
+
+    static const int MinClassShift = 12;    // 4 KB
+    static const int ClassCount = 15;       // up to 64 MB
+
+    static size_t ClassSize(int sizeClass)
+    {
+        return (size_t)1 << (MinClassShift + sizeClass);
+    }
+
+    static int ClassOf(size_t size)
+    {
+        for (int sizeClass = 0; sizeClass < ClassCount; ++sizeClass)
+        {
+            if (size <= ClassSize(sizeClass))
+                return sizeClass;
+        }
+        return -1;
+    }
+
+    // frees the largest idle buffers first until the pool is within budget
+    void Trim()
+    {
+        for (int sizeClass = ClassCount - 1; sizeClass >= 0 && BytesIdle > Budget; --sizeClass)
+        {
+            while (!Free[sizeClass].empty() && BytesIdle > Budget)
+            {
+                free(Free[sizeClass].back());
+                Free[sizeClass].pop_back();
+                BytesIdle -= ClassSize(sizeClass);
+            }
+        }
+    }
+
+    std::mutex Lock;
+    std::vector<Header*> Free[ClassCount];
+    uint64_t Budget = 0;
+    uint64_t BytesIdle = 0;
+    uint64_t Acquires = 0;
+    uint64_t Reuses = 0;
+};
+
+#endif //RLASSETS_POOL_H
@@ -0,0 +1,159 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAssets * Simple Asset Managment System for Raylib
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+#ifndef RLASSETS_STATS_H
+#define RLASSETS_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+/// <summary>
+/// Set by rlas_SetStatsEnabled, counters are only touched while it is on so lookups from many threads do not all write the same cache lines
+/// </summary>
+extern std::atomic<bool> StatsEnabled;
+
+inline bool rlas_StatsOn()
+{
+    return StatsEnabled.load(std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Adds to a counter that is only read for reporting, the cheapest atomic add is enough
+/// </summary>
+inline void rlas_AddStat(std::atomic<uint64_t>& counter, uint64_t value = 1)
+{
+    if (rlas_StatsOn())
+        counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+inline uint64_t rlas_ReadStat(const std::atomic<uint64_t>& counter)
+{
+    return counter.load(std::memory_order_relaxed);
+}
+
+inline uint64_t rlas_StatClock()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// <summary>
+/// Counters kept with each asset
+/// </summary>
+struct rlas_AssetCounters
+{
+    std::atomic<uint64_t> Lookups;
+    std::atomic<uint64_t> Loads;
+    std::atomic<uint64_t> Bytes;
+    std::atomic<uint64_t> LoadNanoseconds;
+
+    rlas_AssetCounters() : Lookups(0), Loads(0), Bytes(0), LoadNanoseconds(0) {}
+
+    void Reset()
+    {
+        Lookups = 0;
+        Loads = 0;
+        Bytes = 0;
+        LoadNanoseconds = 0;
+    }
+};
+
+/// <summary>
+/// Counters for everything rlAssets does, when stats are on every update is one relaxed atomic add
+/// </summary>
+struct rlas_StatCounters
+{
+    std::atomic<uint64_t> Lookups;
+    std::atomic<uint64_t> LookupMisses;
+    std::atomic<uint64_t> Loads;
+    std::atomic<uint64_t> DiskBytes;
+    std::atomic<uint64_t> ArchiveBytes;
+    std::atomic<uint64_t> FileOpens;
+    std::atomic<uint64_t> FileOpenNanoseconds;
+    std::atomic<uint64_t> Inflates;
+    std::atomic<uint64_t> InflatedBytes;
+    std::atomic<uint64_t> InflateNanoseconds;
+    std::atomic<uint64_t> TempExtractions;
+    std::atomic<uint64_t> TempExtractionBytes;
+    std::atomic<uint64_t> ImageCacheHits;
+    std::atomic<uint64_t> ImageCacheMisses;
+
+    rlas_StatCounters()
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        Lookups = 0;
+        LookupMisses = 0;
+        Loads = 0;
+        DiskBytes = 0;
+        ArchiveBytes = 0;
+        FileOpens = 0;
+        FileOpenNanoseconds = 0;
+        Inflates = 0;
+        InflatedBytes = 0;
+        InflateNanoseconds = 0;
+        TempExtractions = 0;
+        TempExtractionBytes = 0;
+        ImageCacheHits = 0;
+        ImageCacheMisses = 0;
+    }
+};
+
+/// <summary>
+/// Adds the time from construction to destruction to a counter, and one to an optional count
+/// The clock is not read when stats are off
+/// </summary>
+class rlas_StatTimer
+{
+public:
+    rlas_StatTimer(std::atomic<uint64_t>& nanoseconds, std::atomic<uint64_t>* count = nullptr) : Nanoseconds(nanoseconds), Count(count), Start(rlas_StatsOn() ? rlas_StatClock() : 0)
+    {
+    }
+
+    ~rlas_StatTimer()
+    {
+        if (Start == 0)
+            return;
+
+        rlas_AddStat(Nanoseconds, rlas_StatClock() - Start);
+        if (Count != nullptr)
+            rlas_AddStat(*Count);
+    }
+
+private:
+    std::atomic<uint64_t>& Nanoseconds;
+    std::atomic<uint64_t>* Count;
+    uint64_t Start;
+};
+
+#endif //RLASSETS_STATS_H
@@ -0,0 +1,131 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAssets * Simple Asset Managment System for Raylib
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+#ifndef RLASSETS_WORKERS_H
+#define RLASSETS_WORKERS_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+
+/// <summary>
+/// A simple pool of worker threads that run queued jobs in the order they were added
+/// Threads are started the first time a job is pushed
+/// </summary>
+class rlas_WorkerPool
+{
+public:
+    ~rlas_WorkerPool()
+    {
+        Stop();
+    }
+
+    /// <summary>
+    /// Sets the number of threads to use, 0 uses one less than the number of cores
+    /// Running threads finish the queued jobs and are restarted with the new count
+    /// </summary>
+    void SetThreadCount(int count)
+    {
+        Stop();
+        ThreadCount = count < 0 ? 0 : count;
+    }
+
+    int GetThreadCount()
+    {
+        if (ThreadCount > 0)
+            return ThreadCount;
+
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        return cores > 2 ? cores - 1 : 1;
+    }
+
+    void Push(std::function<void()> job)
+    {
+        std::unique_lock<std::mutex> lock(Lock);
+        if (Threads.empty())
+        {
+            Stopping = false;
+            int count = GetThreadCount();
+            for (int i = 0; i < count; ++i)
+                Threads.emplace_back(&rlas_WorkerPool::Run, this);
+        }
+
+        Jobs.push_back(std::move(job));
+        Wake.notify_one();
+    }
+
+    /// <summary>
+    /// Finishes all queued jobs and joins the threads
+    /// </summary>
+    void Stop()
+    {
+        std::vector<std::thread> threads;
+        {
+            std::unique_lock<std::mutex> lock(Lock);
+            Stopping = true;
+            threads.swap(Threads);
+            Wake.notify_all();
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+private:
+    void Run()
+    {
+        for (;;)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(Lock);
+                Wake.wait(lock, [this]() { return Stopping || !Jobs.empty(); });
+                if (Jobs.empty())
+                    return;
+
+                job = std::move(Jobs.front());
+                Jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex Lock;
+    std::condition_variable Wake;
+    std::deque<std::function<void()>> Jobs;
+    std::vector<std::thread> Threads;
+    bool Stopping = false;
+    int ThreadCount = 0;
+};
+
+#endif //RLASSETS_WORKERS_H
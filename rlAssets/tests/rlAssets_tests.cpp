@@ -0,0 +1,522 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAsset Tests * Lookup, mount, manifest and pack behavior
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+// Checks the path index and the asset layers against the upper cased std::map the asset map used to be, the map is filled
+// the way the old code filled it, every layer in override order replacing what the ones before it added
+// Usage: rlAssets_tests [work directory]
+// The test files are written to the work directory (rlas_tests by default) and left there, the exit code is the number of failed checks
+
+// rlAssets.cpp is compiled into the tests instead of linked, a program can only have one copy of miniz and the pack writer needs it too
+#include "../rlAssets.cpp"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// keyed by the upper cased virtual path, the value is the file contents
+typedef std::map<std::string, std::string> AssetModel;
+
+struct TestFile
+{
+    std::string Name;
+    std::string Data;
+};
+
+int Failures = 0;
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+bool Check(bool passed, const char* condition, int line)
+{
+    if (!passed)
+    {
+        printf("  failed line %d: %s\n", line, condition);
+        ++Failures;
+    }
+    return passed;
+}
+
+std::string ToUpper(const std::string& path)
+{
+    std::string upperPath = path;
+    for (auto& c : upperPath)
+        c = toupper(c);
+
+    return upperPath;
+}
+
+std::string ToLower(const std::string& path)
+{
+    std::string lowerPath = path;
+    for (auto& c : lowerPath)
+        c = tolower(c);
+
+    return lowerPath;
+}
+
+// creates every directory on the way to a file and writes it
+bool WriteFile(const std::string& root, const std::string& name, const std::string& data)
+{
+    std::string path = root;
+    for (size_t slash = name.find('/'); slash != std::string::npos; slash = name.find('/', slash + 1))
+    {
+        if (!rlas_CreateDirectory((root + name.substr(0, slash)).c_str()))
+            return false;
+    }
+
+    path += name;
+    std::replace(path.begin() + root.size(), path.end(), '/', PathDelim);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && written;
+}
+
+bool WriteFiles(const std::string& root, const std::vector<TestFile>& files)
+{
+    if (!rlas_CreateDirectory(root.c_str()))
+        return false;
+
+    for (auto& file : files)
+    {
+        if (!WriteFile(root, file.Name, file.Data))
+            return false;
+    }
+    return true;
+}
+
+bool WritePack(const std::string& path, const std::vector<TestFile>& files, uint32_t blockSize = rlas_PackDefaultBlockSize)
+{
+    rlas_PackWriter writer(blockSize, 6);
+    bool written = writer.Begin(path.c_str());
+    for (auto& file : files)
+        written = written && writer.Add(file.Name, file.Data.data(), file.Data.size());
+
+    return writer.Finish() && written;
+}
+
+// a layer that overrides everything added so far
+void ApplyOver(AssetModel& model, const std::vector<TestFile>& files, const std::string& prefix = std::string())
+{
+    for (auto& file : files)
+        model[ToUpper(prefix + file.Name)] = file.Data;
+}
+
+// a layer that everything added so far overrides
+void ApplyUnder(AssetModel& model, const std::vector<TestFile>& files, const std::string& prefix = std::string())
+{
+    for (auto& file : files)
+        model.insert(std::make_pair(ToUpper(prefix + file.Name), file.Data));
+}
+
+// a tombstone, a name ending in '/' hides the whole directory
+void Hide(AssetModel& model, const std::string& name)
+{
+    std::string key = ToUpper(name);
+    for (auto item = model.begin(); item != model.end();)
+    {
+        bool hidden = key.back() == '/' ? item->first.compare(0, key.size(), key) == 0 : item->first == key;
+        item = hidden ? model.erase(item) : std::next(item);
+    }
+}
+
+// every path the model has must load with its data, in any case, and every other path that was ever added must miss
+void CheckAssets(const AssetModel& model, const std::vector<std::string>& allNames)
+{
+    std::vector<unsigned char> buffer;
+    for (auto& item : model)
+    {
+        std::string path = ToLower(item.first);
+        unsigned int size = rlas_GetFileSize(path.c_str());
+        if (!CHECK(size == item.second.size()))
+        {
+            printf("    %s\n", item.first.c_str());
+            continue;
+        }
+
+        buffer.assign(size + 1, 0);
+        CHECK(rlas_LoadAssetInto(item.first.c_str(), buffer.data(), (unsigned int)buffer.size()) == size);
+        CHECK(memcmp(buffer.data(), item.second.data(), size) == 0);
+
+        rlas_AssetHandle handle = rlas_ResolveHandle(path.c_str());
+        CHECK(handle != 0 && rlas_GetFileSizeByHandle(handle) == size);
+    }
+
+    for (auto& name : allNames)
+    {
+        if (model.find(ToUpper(name)) == model.end())
+            CHECK(rlas_GetFileSize(name.c_str()) == 0);
+    }
+
+    CHECK(rlas_ListAssetsInPath("", true, nullptr, 0) == (int)model.size());
+}
+
+void AddNames(std::vector<std::string>& allNames, const std::vector<TestFile>& files, const std::string& prefix = std::string())
+{
+    for (auto& file : files)
+        allNames.push_back(prefix + file.Name);
+}
+
+// the path index against std::map, with replaced, removed and added again paths
+void TestPathIndex()
+{
+    printf("path index\n");
+
+    static const char* folders[] = { "textures/", "Textures/UI/", "sounds/", "MUSIC/", "levels/a/", "levels/B/" };
+    std::vector<std::string> names;
+    for (int i = 0; i < 3000; ++i)
+        names.push_back(std::string(folders[i % 6]) + (i % 2 == 0 ? "Asset_" : "asset_") + std::to_string(i) + ".png");
+
+    rlas_PathIndex<int> index;
+    std::map<std::string, int> model;
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        index.Set(names[i], (int)i);
+        model[ToUpper(names[i])] = (int)i;
+    }
+
+    // a path that differs only in case replaces the item
+    for (size_t i = 0; i < names.size(); i += 7)
+    {
+        index.Set(ToUpper(names[i]), -(int)i);
+        model[ToUpper(names[i])] = -(int)i;
+    }
+
+    for (size_t i = 0; i < names.size(); i += 3)
+    {
+        size_t removed = 0;
+        CHECK(index.Remove(ToLower(names[i]), removed) == (model.erase(ToUpper(names[i])) == 1));
+    }
+
+    auto compare = [&]()
+    {
+        CHECK(index.Size() == model.size());
+        for (auto& name : names)
+        {
+            auto expected = model.find(ToUpper(name));
+            const std::string variants[] = { name, ToUpper(name), ToLower(name) };
+            for (auto& variant : variants)
+            {
+                const int* found = index.Find(variant.c_str());
+                CHECK(expected == model.end() ? found == nullptr : found != nullptr && *found == expected->second);
+            }
+            CHECK(index.Find((name + ".missing").c_str()) == nullptr);
+        }
+
+        for (size_t i = 0; i < index.Size(); ++i)
+        {
+            auto expected = model.find(ToUpper(index.NameAt(i)));
+            CHECK(expected != model.end() && expected->second == index.ItemAt(i));
+        }
+    };
+    compare();
+
+    // removed paths are added again in a different case
+    for (size_t i = 0; i < names.size(); i += 3)
+    {
+        index.Set(ToLower(names[i]), (int)i);
+        model[ToUpper(names[i])] = (int)i;
+    }
+    compare();
+}
+
+static const std::vector<TestFile> BaseFiles =
+{
+    { "readme.txt", "base readme" },
+    { "Textures/Hero.png", "base hero" },
+    { "textures/ui/button.png", "base button" },
+    { "sounds/hit.ogg", "base hit" },
+    { "levels/a/map.json", "base map a" },
+    { "levels/a/props.json", "base props a" },
+};
+
+static const std::vector<TestFile> PatchFiles =
+{
+    { "textures/hero.PNG", "patch hero" },
+    { "levels/b/map.json", "patch map b" },
+};
+
+static const std::vector<TestFile> ArchiveFiles =
+{
+    { "SOUNDS/hit.ogg", "archive hit" },
+    { "levels/b/map.json", "archive map b" },
+};
+
+// two resource paths and a resource archive, each overriding the ones before, and the same again through a manifest
+// with lazy indexing the archive is read before the directories it overrides
+void TestResourcePaths(const std::string& work, bool lazy)
+{
+    printf("resource paths%s\n", lazy ? ", lazy" : "");
+
+    std::string base = work + "base" + PathDelim;
+    std::string patch = work + "patch" + PathDelim;
+    std::string archive = work + "archive.rlpak";
+    std::string manifest = work + (lazy ? "lazy_manifest.bin" : "manifest.bin");
+    if (!CHECK(WriteFiles(base, BaseFiles) && WriteFiles(patch, PatchFiles) && WritePack(archive, ArchiveFiles)))
+        return;
+
+    AssetModel model;
+    ApplyOver(model, BaseFiles);
+    ApplyOver(model, PatchFiles);
+    ApplyOver(model, ArchiveFiles);
+
+    std::vector<std::string> allNames;
+    AddNames(allNames, BaseFiles);
+    AddNames(allNames, PatchFiles);
+    AddNames(allNames, ArchiveFiles);
+
+    rlas_SetLazyIndexing(lazy);
+    rlas_SetAssetRootPath(base.c_str(), false);
+    rlas_AddAssetResourcePath(patch.c_str());
+    rlas_SetLazyIndexing(false);
+    rlas_AddAssetResourceArchive(archive.c_str(), false);
+
+    // a lazy manifest is saved before anything is read, so it keeps every directory lazy
+    if (lazy)
+        CHECK(rlas_SaveAssetManifest(manifest.c_str()));
+
+    CheckAssets(model, allNames);
+
+    if (!lazy)
+        CHECK(rlas_SaveAssetManifest(manifest.c_str()));
+
+    rlas_Cleanup();
+
+    printf("manifest%s\n", lazy ? ", lazy" : "");
+    CHECK(rlas_LoadAssetManifest(manifest.c_str()));
+    CheckAssets(model, allNames);
+    rlas_Cleanup();
+}
+
+static const std::vector<TestFile> LowFiles =
+{
+    { "readme.txt", "low readme" },
+    { "extra/low.txt", "low extra" },
+};
+
+static const std::vector<TestFile> ModFiles =
+{
+    { "a.txt", "mod a" },
+    { "b/c.txt", "mod c" },
+};
+
+static const std::vector<TestFile> RootModFiles =
+{
+    { "Levels/B/map.json", "root mod map b" },
+};
+
+static const std::vector<TestFile> HotfixFiles =
+{
+    { "sounds/hit.ogg", "hotfix hit" },
+    { "levels/a/map.json", "hotfix map a" },
+};
+
+static const std::vector<TestFile> HotfixFiles2 =
+{
+    { "Sounds/Hit.ogg", "second hotfix hit" },
+};
+
+// mounts at every priority, a prefix mount, tombstones, and unmounting them again
+void TestMounts(const std::string& work)
+{
+    printf("mounts\n");
+
+    std::string base = work + "base" + PathDelim;
+    std::string patch = work + "patch" + PathDelim;
+    std::string low = work + "low" + PathDelim;
+    std::string mod = work + "mod" + PathDelim;
+    std::string rootMod = work + "rootmod" + PathDelim;
+    std::string hotfix = work + "hotfix" + PathDelim;
+    std::string hotfix2 = work + "hotfix2" + PathDelim;
+
+    // the tombstones hide a directory of the base path, with the file the hotfix puts back in it, and a file of every layer
+    std::vector<TestFile> hotfixDisk = HotfixFiles;
+    hotfixDisk.push_back({ "rlas_tombstones.txt", "# hidden by the hotfix\nlevels/a/\nreadme.txt\n" });
+    if (!CHECK(WriteFiles(base, BaseFiles) && WriteFiles(patch, PatchFiles) && WriteFiles(low, LowFiles) && WriteFiles(mod, ModFiles) && WriteFiles(rootMod, RootModFiles)
+        && WriteFiles(hotfix, hotfixDisk) && WriteFiles(hotfix2, HotfixFiles2)))
+        return;
+
+    std::vector<std::string> allNames;
+    AddNames(allNames, BaseFiles);
+    AddNames(allNames, PatchFiles);
+    AddNames(allNames, LowFiles);
+    AddNames(allNames, ModFiles, "mods/m/");
+    AddNames(allNames, HotfixFiles);
+    allNames.push_back("rlas_tombstones.txt");
+
+    rlas_SetAssetRootPath(base.c_str(), false);
+    rlas_AddAssetResourcePath(patch.c_str());
+
+    AssetModel model;
+    ApplyOver(model, BaseFiles);
+    ApplyOver(model, PatchFiles);
+    AssetModel roots = model;
+
+    rlas_MountId lowMount = rlas_Mount(low.c_str(), "", -1);
+    ApplyUnder(model, LowFiles);
+    CheckAssets(model, allNames);
+
+    rlas_MountId modMount = rlas_Mount(mod.c_str(), "mods/m", 0);
+    ApplyOver(model, ModFiles, "mods/m/");
+    CheckAssets(model, allNames);
+    CHECK(rlas_ListAssetsInPath("mods/m", false, nullptr, 0) == 1);
+
+    // at priority 0 a mount overrides the resource paths added before it
+    rlas_MountId rootModMount = rlas_Mount(rootMod.c_str(), "", 0);
+    ApplyOver(model, RootModFiles);
+    CheckAssets(model, allNames);
+
+    rlas_MountId hotfixMount = rlas_Mount(hotfix.c_str(), "", 5);
+    Hide(model, "levels/a/");
+    Hide(model, "readme.txt");
+    ApplyOver(model, HotfixFiles);
+    AssetModel hotfixed = model;
+    CheckAssets(model, allNames);
+    CHECK(rlas_ListAssetsInPath("levels/a", false, nullptr, 0) == 1);
+
+    // at the same priority the later mount wins
+    rlas_MountId hotfix2Mount = rlas_Mount(hotfix2.c_str(), "", 5);
+    ApplyOver(model, HotfixFiles2);
+    CheckAssets(model, allNames);
+
+    CHECK(rlas_Unmount(hotfix2Mount));
+    CHECK(!rlas_Unmount(hotfix2Mount));
+    CheckAssets(hotfixed, allNames);
+
+    CHECK(rlas_Unmount(hotfixMount) && rlas_Unmount(rootModMount) && rlas_Unmount(modMount) && rlas_Unmount(lowMount));
+    CheckAssets(roots, allNames);
+
+    rlas_Cleanup();
+}
+
+// a pack written by rlas_PackWriter read back whole and in ranges that cross blocks, found in a resource path,
+// added as a resource archive and mounted
+void TestPack(const std::string& work)
+{
+    printf("pack\n");
+
+    std::vector<TestFile> files =
+    {
+        { "text/hello.txt", "hello from a pack" },
+        { "Data/Random.bin", std::string() },
+        { "data/repeat.bin", std::string(5000, 'r') },
+    };
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 10000; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        files[1].Data += (char)(state >> 56);
+    }
+
+    std::string directory = work + "packed" + PathDelim;
+    std::string path = directory + "assets.rlpak";
+    CHECK(rlas_CreateDirectory(directory.c_str()));
+
+    if (!CHECK(WritePack(path, files, 1024)))
+        return;
+
+    // names that differ only in case are the same entry
+    {
+        std::string duplicate = work + "duplicate.rlpak";
+        rlas_PackWriter writer;
+        CHECK(writer.Begin(duplicate.c_str()) && writer.Add("text/hello.txt", "one", 3) && !writer.Add("TEXT/HELLO.TXT", "two", 3));
+        writer.Finish();
+        remove(duplicate.c_str());
+    }
+
+    std::vector<std::string> allNames;
+    AddNames(allNames, files);
+    AddNames(allNames, files, "assets/");
+    AddNames(allNames, files, "packed/");
+
+    // a pack in a resource path is a directory named after it
+    AssetModel model;
+    ApplyOver(model, files, "assets/");
+    rlas_SetAssetRootPath(directory.c_str(), false);
+    CheckAssets(model, allNames);
+
+    ApplyOver(model, files);
+    rlas_AddAssetResourceArchive(path.c_str(), false);
+    CheckAssets(model, allNames);
+    CHECK(rlas_FileIsArchive("assets/text/hello.txt"));
+
+    // ranges that start and end inside blocks of the random entry, which is stored, and of the deflated one
+    char buffer[3000];
+    const std::string& random = files[1].Data;
+    CHECK(rlas_ReadAssetRange("assets/data/random.bin", 1500, buffer, sizeof(buffer)) == sizeof(buffer));
+    CHECK(memcmp(buffer, random.data() + 1500, sizeof(buffer)) == 0);
+    CHECK(rlas_ReadAssetRange("assets/data/random.bin", random.size() - 10, buffer, sizeof(buffer)) == 10);
+    CHECK(memcmp(buffer, random.data() + random.size() - 10, 10) == 0);
+    CHECK(rlas_ReadAssetRange("assets/data/repeat.bin", 1000, buffer, 100) == 100 && buffer[0] == 'r' && buffer[99] == 'r');
+
+    rlas_MountId mount = rlas_Mount(path.c_str(), "packed", 0);
+    ApplyOver(model, files, "packed/");
+    CheckAssets(model, allNames);
+    CHECK(rlas_Unmount(mount));
+
+    rlas_Cleanup();
+}
+
+int main(int argc, char* argv[])
+{
+    std::string work = argc > 1 ? argv[1] : "rlas_tests";
+    if (work.back() != '/' && work.back() != PathDelim)
+        work += PathDelim;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    if (!rlas_CreateDirectory(work.c_str()))
+    {
+        printf("could not create %s\n", work.c_str());
+        return 1;
+    }
+
+    TestPathIndex();
+    TestResourcePaths(work, false);
+    TestResourcePaths(work, true);
+    TestMounts(work);
+    TestPack(work);
+
+    if (Failures == 0)
+        printf("all passed\n");
+    else
+        printf("%d failed\n", Failures);
+
+    return Failures;
+}
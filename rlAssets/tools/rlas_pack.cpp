@@ -0,0 +1,156 @@
+/**********************************************************************************************
+*
+*   raylibExtras * Utilities and Shared Components for Raylib
+*
+*   RLAssets Pack * Builds rlAssets pack files from a directory
+*
+*   LICENSE: MIT
+*
+*   Copyright (c) 2020 Jeffery Myers
+*
+*   Permission is hereby granted, free of charge, to any person obtaining a copy
+*   of this software and associated documentation files (the "Software"), to deal
+*   in the Software without restriction, including without limitation the rights
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+*   copies of the Software, and to permit persons to whom the Software is
+*   furnished to do so, subject to the following conditions:
+*
+*   The above copyright notice and this permission notice shall be included in all
+*   copies or substantial portions of the Software.
+*
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*   SOFTWARE.
+*
+**********************************************************************************************/
+
+
+// Usage: rlas_pack <input directory> <output file> [-b block size in KB] [-l deflate level 0-10]
+// Every file under the input directory is added with its path relative to the directory, using '/' separators
+
+#include "../rlAssets_pack.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+constexpr char PathDelim = '\\';
+#else
+constexpr char PathDelim = '/';
+#endif // OSs
+
+struct PackInput
+{
+    std::string Name;
+    std::string Path;
+};
+
+void FindFiles(const std::string& path, const std::string& relPath, std::vector<PackInput>& files)
+{
+    std::vector<rlas_DirectoryEntry> entries;
+    rlas_ListDirectory(path.c_str(), entries);
+
+    for (auto& entry : entries)
+    {
+        if (entry.IsDirectory)
+            FindFiles(path + entry.Name + PathDelim, relPath + entry.Name + "/", files);
+        else
+            files.push_back(PackInput{ relPath + entry.Name, path + entry.Name });
+    }
+}
+
+bool ReadFile(const std::string& path, std::vector<unsigned char>& data)
+{
+    data.clear();
+
+    uint64_t size = 0;
+    int file = rlas_OpenReadFile(path.c_str(), &size);
+    if (file < 0)
+        return false;
+
+    bool read = size <= SIZE_MAX;
+    if (read && size > 0)
+    {
+        data.resize((size_t)size);
+        read = rlas_ReadFileAt(file, 0, data.data(), data.size()) == data.size();
+    }
+
+    rlas_CloseReadFile(file);
+    return read;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        printf("usage: rlas_pack <input directory> <output file> [-b block size in KB] [-l deflate level 0-10]\n");
+        return 1;
+    }
+
+    std::string input = argv[1];
+    if (input.back() != '/' && input.back() != PathDelim)
+        input += PathDelim;
+
+    uint32_t blockSize = rlas_PackDefaultBlockSize;
+    int level = 6;
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-b") == 0)
+            blockSize = (uint32_t)atoi(argv[i + 1]) * 1024;
+        else if (strcmp(argv[i], "-l") == 0)
+            level = atoi(argv[i + 1]);
+    }
+
+    if (blockSize == 0)
+    {
+        printf("block size must be at least 1 KB\n");
+        return 1;
+    }
+
+    std::vector<PackInput> files;
+    FindFiles(input, "", files);
+    std::sort(files.begin(), files.end(), [](const PackInput& a, const PackInput& b) { return a.Name < b.Name; });
+
+    rlas_PackWriter writer(blockSize, std::min(std::max(level, 0), 10));
+    if (!writer.Begin(argv[2]))
+    {
+        printf("could not create %s\n", argv[2]);
+        return 1;
+    }
+
+    uint64_t totalSize = 0;
+    std::vector<unsigned char> data;
+    for (auto& file : files)
+    {
+        if (!ReadFile(file.Path, data))
+        {
+            printf("could not read %s\n", file.Path.c_str());
+            return 1;
+        }
+
+        if (!writer.Add(file.Name, data.data(), data.size()))
+        {
+            printf("could not add %s, the name may differ from another file only by case\n", file.Name.c_str());
+            return 1;
+        }
+
+        totalSize += data.size();
+    }
+
+    if (!writer.Finish())
+    {
+        printf("could not write %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("packed %d files, %llu bytes\n", (int)files.size(), (unsigned long long)totalSize);
+    return 0;
+}
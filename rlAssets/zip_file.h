@@ -5153,8 +5153,10 @@ namespace miniz_cpp {
         uint32_t external_attr = 0;
         std::size_t header_offset = 0;
         uint32_t crc = 0;
+        uint16_t compress_type = 0;
         std::size_t compress_size = 0;
         std::size_t file_size = 0;
+        int file_index = -1;
     };
 
     class zip_file
@@ -5208,6 +5210,17 @@ namespace miniz_cpp {
             start_read();
         }
 
+        // Reads the archive in place from memory owned by the caller (such as a memory mapped file).
+        // Only the central directory is read here, the memory is never modified and must stay valid until reset() or destruction.
+        // Writing or saving copies the archive into the internal buffer first.
+        void load_view(const void* data, std::size_t size)
+        {
+            reset();
+            view_ = static_cast<const char*>(data);
+            view_size_ = size;
+            start_read();
+        }
+
         void save(const std::string& filename)
         {
             filename_ = filename;
@@ -5217,6 +5230,8 @@ namespace miniz_cpp {
 
         void save(std::ostream& stream)
         {
+            copy_view();
+
             if (archive_->m_zip_mode == MZ_ZIP_MODE_WRITING)
             {
                 mz_zip_writer_finalize_archive(archive_.get());
@@ -5238,6 +5253,8 @@ namespace miniz_cpp {
 
         void save(std::vector<unsigned char>& bytes)
         {
+            copy_view();
+
             if (archive_->m_zip_mode == MZ_ZIP_MODE_WRITING)
             {
                 mz_zip_writer_finalize_archive(archive_.get());
@@ -5281,6 +5298,8 @@ namespace miniz_cpp {
             }
 
             buffer_.clear();
+            view_ = nullptr;
+            view_size_ = 0;
             comment.clear();
 
             start_write();
@@ -5448,10 +5467,13 @@ namespace miniz_cpp {
             stream << std::endl;
         }
 
+        // Reads from an archive that is open for reading keep their state on the caller's stack,
+        // so one archive can be read from several threads at once. open() is not safe to share, it uses one stream.
         std::string read(const zip_info& info)
         {
-            std::size_t size;
-            char* data = static_cast<char*>(mz_zip_reader_extract_file_to_heap(archive_.get(), info.filename.c_str(), &size, 0));
+            std::size_t size = 0;
+            int index = file_index(info);
+            char* data = index < 0 ? nullptr : static_cast<char*>(mz_zip_reader_extract_to_heap(archive_.get(), static_cast<mz_uint>(index), &size, 0));
             if (data == nullptr)
             {
                 throw std::runtime_error("file couldn't be read");
@@ -5469,7 +5491,11 @@ namespace miniz_cpp {
         void* readBin(const zip_info& info, std::size_t& size)
         {
             size = 0;
-            return mz_zip_reader_extract_file_to_heap(archive_.get(), info.filename.c_str(), &size, 0);
+            int index = file_index(info);
+            if (index < 0)
+                return nullptr;
+
+            return mz_zip_reader_extract_to_heap(archive_.get(), static_cast<mz_uint>(index), &size, 0);
         }
 
         void* readBin(const std::string& name, std::size_t& size)
@@ -5484,7 +5510,8 @@ namespace miniz_cpp {
 
         std::size_t readBin(const zip_info& info, void* buffer)
         {
-            if (!mz_zip_reader_extract_file_to_mem(archive_.get(), info.filename.c_str(), buffer, info.file_size, 0))
+            int index = file_index(info);
+            if (index < 0 || !mz_zip_reader_extract_to_mem(archive_.get(), static_cast<mz_uint>(index), buffer, info.file_size, 0))
                 return 0;
 
             return info.file_size;
@@ -5495,6 +5522,45 @@ namespace miniz_cpp {
             return readBin(getinfo(name), buffere);
         }
 
+        // Returns a pointer directly into the archive data for an entry that is stored without compression or encryption.
+        // Returns nullptr for any other entry. The pointer is valid until the archive is reset, written to, or destroyed.
+        const void* stored_data(const zip_info& info)
+        {
+            if (info.compress_type != 0 || info.compress_size != info.file_size)
+            {
+                return nullptr;
+            }
+
+            return entry_data(info);
+        }
+
+        // Returns a pointer directly to the compress_size bytes of an unencrypted entry as they are stored in the archive (deflated unless compress_type is 0).
+        // Returns nullptr for an encrypted entry. The pointer is valid until the archive is reset, written to, or destroyed.
+        const void* entry_data(const zip_info& info)
+        {
+            if (archive_->m_zip_mode != MZ_ZIP_MODE_READING || (info.flag_bits & 1) != 0)
+            {
+                return nullptr;
+            }
+
+            const unsigned char* data = reinterpret_cast<const unsigned char*>(view_ != nullptr ? view_ : buffer_.data());
+            std::size_t size = view_ != nullptr ? view_size_ : buffer_.size();
+
+            std::size_t offset = info.header_offset;
+            if (offset + MZ_ZIP_LOCAL_DIR_HEADER_SIZE > size || MZ_READ_LE32(data + offset) != MZ_ZIP_LOCAL_DIR_HEADER_SIG)
+            {
+                return nullptr;
+            }
+
+            offset += MZ_ZIP_LOCAL_DIR_HEADER_SIZE + MZ_READ_LE16(data + offset + MZ_ZIP_LDH_FILENAME_LEN_OFS) + MZ_READ_LE16(data + offset + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+            if (offset + info.compress_size > size)
+            {
+                return nullptr;
+            }
+
+            return data + offset;
+        }
+
 
 
         std::pair<bool, std::string> testzip()
@@ -5591,16 +5657,53 @@ namespace miniz_cpp {
                 mz_zip_writer_end(archive_.get());
             }
 
-            if (!mz_zip_reader_init_mem(archive_.get(), buffer_.data(), buffer_.size(), 0))
+            const char* data = view_ != nullptr ? view_ : buffer_.data();
+            std::size_t size = view_ != nullptr ? view_size_ : buffer_.size();
+
+            if (!mz_zip_reader_init_mem(archive_.get(), data, size, 0))
             {
                 throw std::runtime_error("bad zip");
             }
         }
 
+        // the central directory index of an entry, infos from infolist()/getinfo() carry it so the name does not need to be looked up again
+        int file_index(const zip_info& info)
+        {
+            if (archive_->m_zip_mode != MZ_ZIP_MODE_READING)
+            {
+                start_read();
+            }
+
+            if (info.file_index >= 0 && static_cast<mz_uint>(info.file_index) < mz_zip_reader_get_num_files(archive_.get()))
+            {
+                return info.file_index;
+            }
+
+            return mz_zip_reader_locate_file(archive_.get(), info.filename.c_str(), nullptr, 0);
+        }
+
+        void copy_view()
+        {
+            if (view_ == nullptr) return;
+
+            if (archive_->m_zip_mode == MZ_ZIP_MODE_READING)
+            {
+                mz_zip_reader_end(archive_.get());
+            }
+
+            buffer_.assign(view_, view_ + view_size_);
+            view_ = nullptr;
+            view_size_ = 0;
+            remove_comment();
+            start_read();
+        }
+
         void start_write()
         {
             if (archive_->m_zip_mode == MZ_ZIP_MODE_WRITING) return;
 
+            copy_view();
+
             switch (archive_->m_zip_mode)
             {
             case MZ_ZIP_MODE_READING:
@@ -5732,12 +5835,16 @@ namespace miniz_cpp {
             result.create_version = stat.m_version_made_by;
             result.volume = stat.m_file_index;
             result.create_system = stat.m_method;
+            result.compress_type = stat.m_method;
+            result.file_index = index;
 
             return result;
         }
 
         std::unique_ptr<mz_zip_archive> archive_;
         std::vector<char> buffer_;
+        const char* view_ = nullptr;
+        std::size_t view_size_ = 0;
         std::stringstream open_stream_;
         std::string filename_;
     };